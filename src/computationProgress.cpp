@@ -0,0 +1,68 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "computationProgress.h"
+#include "progress.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include <maya/MComputation.h>
+#include <maya/MGlobal.h>
+#include <maya/MTypes.h>
+
+
+namespace
+{
+    const int PROGRESS_RANGE = 100;
+}
+
+
+ComputationProgress::ComputationProgress()
+{
+#if MAYA_API_VERSION >= 201600
+    computation.beginComputation(true, true, true);
+    computation.setProgressRange(0, PROGRESS_RANGE);
+#else
+    computation.beginComputation();
+#endif
+}
+
+
+ComputationProgress::~ComputationProgress()
+{
+    computation.endComputation();
+}
+
+
+/**
+    Each phase fills the bar again from empty.
+*/
+void ComputationProgress::beginPhase(const char *, size_t)
+{
+#if MAYA_API_VERSION >= 201600
+    computation.setProgress(0);
+#endif
+}
+
+
+bool ComputationProgress::update(size_t stepsDone, size_t numberOfSteps)
+{
+#if MAYA_API_VERSION >= 201600
+    if (numberOfSteps != 0)
+    {
+        size_t percent = std::min(stepsDone, numberOfSteps) * PROGRESS_RANGE / numberOfSteps;
+        computation.setProgress((int) percent);
+    }
+#endif
+
+    if (computation.isInterruptRequested())
+    {
+        MGlobal::displayWarning("polyReorder - interrupted, the meshes were left as they were.");
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,34 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#ifndef YANTOR3D_COMPUTATION_PROGRESS_H
+#define YANTOR3D_COMPUTATION_PROGRESS_H
+
+#include "progress.h"
+
+#include <cstddef>
+
+#include <maya/MComputation.h>
+
+/**
+    Shows the progress of a command in Maya's main progress bar and lets the
+    user stop it with Esc, which is reported once as a warning. The
+    computation runs from construction to destruction, so it ends however
+    the command returns.
+*/
+class ComputationProgress : public ProgressMonitor
+{
+public:
+                        ComputationProgress();
+    virtual             ~ComputationProgress();
+
+    virtual void        beginPhase(const char *phase, size_t numberOfSteps);
+    virtual bool        update(size_t stepsDone, size_t numberOfSteps);
+
+private:
+    MComputation        computation;
+};
+
+#endif
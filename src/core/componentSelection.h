@@ -0,0 +1,21 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#ifndef YANTOR3D_COMPONENT_SELECTION_H
+#define YANTOR3D_COMPONENT_SELECTION_H
+
+namespace polyReorder
+{
+    struct ComponentSelection
+    {
+        int vertexIndex;
+        int edgeIndex;
+        int faceIndex;
+
+        ComponentSelection() {}
+    };
+}
+
+#endif
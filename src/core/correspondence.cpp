@@ -0,0 +1,563 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "componentSelection.h"
+#include "correspondence.h"
+#include "meshData.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+    const int SIGNATURE_CHUNK_SIZE = 1 << 14;
+    const int PARALLEL_MATCH_WORK = 1 << 14;
+    const int MAX_SIGNATURE_BUCKETS = 1 << 22;
+
+    inline uint64_t mix(uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    /**
+        An oriented corner is a corner plus the direction to step around its
+        face - 2 * corner for nextCorner, 2 * corner + 1 for prevCorner. Its
+        edge runs from the corner's vertex to the next one in that direction.
+    */
+    inline int orientedCorner(int corner, bool forward) { return corner * 2 + (forward ? 0 : 1); }
+    inline int cornerOf(int oriented) { return oriented >> 1; }
+    inline bool isForward(int oriented) { return (oriented & 1) == 0; }
+
+    inline int stepCorner(const MeshData &mesh, int corner, bool forward)
+    {
+        return forward ? mesh.nextCorner(corner) : mesh.prevCorner(corner);
+    }
+
+    inline int orientedEdge(const MeshData &mesh, int oriented)
+    {
+        int corner = cornerOf(oriented);
+        return isForward(oriented) ? mesh.cornerEdge(corner) : mesh.cornerEdge(mesh.prevCorner(corner));
+    }
+
+    /**
+        Face shells of a mesh - faces joined by an edge share a shell.
+    */
+    struct Shells
+    {
+        std::vector<int>    faceShell;
+        std::vector<int>    shellSize;
+    };
+
+    void getShells(const MeshData &mesh, Shells &shells)
+    {
+        int numberOfFaces = mesh.numberOfFaces;
+
+        std::vector<int> root(numberOfFaces);
+
+        for (int f = 0; f < numberOfFaces; f++)
+        {
+            root[f] = f;
+        }
+
+        auto find = [&root](int f)
+        {
+            while (root[f] != f)
+            {
+                root[f] = root[root[f]];
+                f = root[f];
+            }
+
+            return f;
+        };
+
+        for (int e = 0; e < mesh.numberOfEdges; e++)
+        {
+            IndexRange edgeFaces = mesh.edgeFaces(e);
+
+            for (int f : edgeFaces)
+            {
+                int a = find(edgeFaces[0]);
+                int b = find(f);
+
+                if (a < b) { root[b] = a; } else if (b < a) { root[a] = b; }
+            }
+        }
+
+        shells.faceShell.assign(numberOfFaces, -1);
+        shells.shellSize.clear();
+
+        for (int f = 0; f < numberOfFaces; f++)
+        {
+            int r = find(f);
+
+            if (r == f)
+            {
+                shells.faceShell[f] = (int) shells.shellSize.size();
+                shells.shellSize.push_back(0);
+            } else {
+                shells.faceShell[f] = shells.faceShell[r];
+            }
+
+            shells.shellSize[shells.faceShell[f]]++;
+        }
+    }
+
+    /**
+        Local invariants of every oriented corner - face degree, the valence
+        and ring signature of both ends of its edge, and whether that edge is
+        on a border.
+    */
+    void getCornerSignatures(const MeshData &mesh, int numberOfThreads, std::vector<uint64_t> &signatures)
+    {
+        int numberOfVertices = mesh.numberOfVertices;
+        int numberOfCorners = mesh.numberOfCorners;
+
+        std::vector<uint64_t> rings(numberOfVertices);
+
+        int numberOfChunks = (numberOfVertices + SIGNATURE_CHUNK_SIZE - 1) / SIGNATURE_CHUNK_SIZE;
+
+        polyReorder::parallelFor(numberOfChunks, numberOfThreads, [&](int chunk)
+        {
+            int last = std::min((chunk + 1) * SIGNATURE_CHUNK_SIZE, numberOfVertices);
+
+            for (int v = chunk * SIGNATURE_CHUNK_SIZE; v < last; v++)
+            {
+                uint64_t ring = mix(uint64_t(mesh.vertexEdges(v).size()));
+
+                for (int f : mesh.vertexFaces(v))
+                {
+                    ring += mix(uint64_t(mesh.faceSize(f)) << 32);
+                }
+
+                for (int u : mesh.vertexVertices(v))
+                {
+                    ring += mix(uint64_t(mesh.vertexEdges(u).size()) << 16);
+                }
+
+                rings[v] = ring;
+            }
+        });
+
+        signatures.resize(numberOfCorners * 2);
+
+        numberOfChunks = (numberOfCorners + SIGNATURE_CHUNK_SIZE - 1) / SIGNATURE_CHUNK_SIZE;
+
+        polyReorder::parallelFor(numberOfChunks, numberOfThreads, [&](int chunk)
+        {
+            int last = std::min((chunk + 1) * SIGNATURE_CHUNK_SIZE, numberOfCorners);
+
+            for (int c = chunk * SIGNATURE_CHUNK_SIZE; c < last; c++)
+            {
+                uint64_t face = mix(uint64_t(mesh.faceSize(mesh.cornerFace(c))));
+                uint64_t ring = rings[mesh.cornerVertex(c)];
+
+                for (int direction = 0; direction < 2; direction++)
+                {
+                    int oriented = orientedCorner(c, direction == 0);
+                    int other = stepCorner(mesh, c, direction == 0);
+
+                    uint64_t border = mesh.edgeFaces(orientedEdge(mesh, oriented)).size();
+
+                    signatures[oriented] = mix(mix(face ^ ring) ^ (rings[mesh.cornerVertex(other)] * 0xff51afd7ed558ccdULL)) ^ border;
+                }
+            }
+        });
+    }
+
+    /**
+        Per-thread state for matching one source shell against a candidate.
+        Everything that is written is recorded so it can be undone in time
+        proportional to the shell, not the mesh.
+    */
+    struct ShellMatcher
+    {
+        const MeshData                  *source = nullptr;
+        const MeshData                  *destination = nullptr;
+
+        std::vector<int>                sourceVertexMap;
+        std::vector<int>                destinationVertexMap;
+        std::vector<int>                sourceFaceMap;
+        std::vector<char>               destinationFaceUsed;
+
+        std::vector<int>                touchedSourceVertices;
+        std::vector<int>                touchedSourceFaces;
+        std::vector<int>                touchedDestinationFaces;
+
+        std::vector<std::pair<int, int>>    pending;
+
+        void    init(const MeshData &sourceMesh, const MeshData &destinationMesh);
+        bool    match(int sourceOriented, int destinationOriented, int shellSize);
+        bool    mapVertex(int sourceVertex, int destinationVertex);
+        void    clear();
+    };
+
+    void ShellMatcher::init(const MeshData &sourceMesh, const MeshData &destinationMesh)
+    {
+        source = &sourceMesh;
+        destination = &destinationMesh;
+
+        sourceVertexMap.assign(sourceMesh.numberOfVertices, -1);
+        destinationVertexMap.assign(destinationMesh.numberOfVertices, -1);
+        sourceFaceMap.assign(sourceMesh.numberOfFaces, -1);
+        destinationFaceUsed.assign(destinationMesh.numberOfFaces, 0);
+    }
+
+    bool ShellMatcher::mapVertex(int sourceVertex, int destinationVertex)
+    {
+        int mapped = sourceVertexMap[sourceVertex];
+
+        if (mapped == -1)
+        {
+            if (destinationVertexMap[destinationVertex] != -1) { return false; }
+
+            sourceVertexMap[sourceVertex] = destinationVertex;
+            destinationVertexMap[destinationVertex] = sourceVertex;
+            touchedSourceVertices.push_back(sourceVertex);
+
+            return true;
+        }
+
+        return mapped == destinationVertex;
+    }
+
+    void ShellMatcher::clear()
+    {
+        for (int v : touchedSourceVertices)
+        {
+            destinationVertexMap[sourceVertexMap[v]] = -1;
+            sourceVertexMap[v] = -1;
+        }
+
+        for (int f : touchedSourceFaces) { sourceFaceMap[f] = -1; }
+        for (int f : touchedDestinationFaces) { destinationFaceUsed[f] = 0; }
+
+        touchedSourceVertices.clear();
+        touchedSourceFaces.clear();
+        touchedDestinationFaces.clear();
+        pending.clear();
+    }
+
+    /**
+        Matches the shell around sourceOriented onto the destination, starting
+        with sourceOriented lined up against destinationOriented. Each pending
+        pair lines up two corners; a source step in its own direction is a
+        destination step in the paired direction. Faces are matched corner by
+        corner, then the match crosses every manifold edge to the neighbours
+        on both sides. It succeeds when all shellSize faces are matched with
+        consistent vertices and matching borders.
+    */
+    bool ShellMatcher::match(int sourceOriented, int destinationOriented, int shellSize)
+    {
+        const MeshData &src = *source;
+        const MeshData &dst = *destination;
+
+        bool result = true;
+        int matchedFaces = 0;
+
+        pending.push_back(std::make_pair(sourceOriented, destinationOriented));
+
+        for (size_t p = 0; p < pending.size() && result; p++)
+        {
+            int sourceCorner = cornerOf(pending[p].first);
+            int destinationCorner = cornerOf(pending[p].second);
+            bool sourceForward = isForward(pending[p].first);
+            bool destinationForward = isForward(pending[p].second);
+
+            int sourceFace = src.cornerFace(sourceCorner);
+            int destinationFace = dst.cornerFace(destinationCorner);
+
+            if (sourceFaceMap[sourceFace] != -1)
+            {
+                result = (
+                       sourceFaceMap[sourceFace] == destinationFace
+                    && mapVertex(src.cornerVertex(sourceCorner), dst.cornerVertex(destinationCorner))
+                );
+
+                continue;
+            }
+
+            if (destinationFaceUsed[destinationFace] || src.faceSize(sourceFace) != dst.faceSize(destinationFace))
+            {
+                result = false;
+                break;
+            }
+
+            sourceFaceMap[sourceFace] = destinationFace;
+            destinationFaceUsed[destinationFace] = 1;
+            touchedSourceFaces.push_back(sourceFace);
+            touchedDestinationFaces.push_back(destinationFace);
+            matchedFaces++;
+
+            int faceSize = src.faceSize(sourceFace);
+
+            for (int i = 0; i < faceSize && result; i++)
+            {
+                int sourceOther = stepCorner(src, sourceCorner, sourceForward);
+                int destinationOther = stepCorner(dst, destinationCorner, destinationForward);
+
+                result = mapVertex(src.cornerVertex(sourceCorner), dst.cornerVertex(destinationCorner));
+
+                int sourceEdgeCorner = sourceForward ? sourceCorner : sourceOther;
+                int destinationEdgeCorner = destinationForward ? destinationCorner : destinationOther;
+
+                int sourceEdgeFaces = src.edgeFaces(src.cornerEdge(sourceEdgeCorner)).size();
+                int destinationEdgeFaces = dst.edgeFaces(dst.cornerEdge(destinationEdgeCorner)).size();
+
+                if (sourceEdgeFaces != destinationEdgeFaces)
+                {
+                    result = false;
+                } else if (result && sourceEdgeFaces == 2) {
+                    int sourceTwin = src.twinCorner(sourceEdgeCorner);
+                    int destinationTwin = dst.twinCorner(destinationEdgeCorner);
+
+                    bool sourceStartsHere = src.cornerVertex(sourceTwin) == src.cornerVertex(sourceCorner);
+                    int expected = dst.cornerVertex(sourceStartsHere ? destinationCorner : destinationOther);
+
+                    if (dst.cornerVertex(destinationTwin) == expected)
+                    {
+                        pending.push_back(std::make_pair(
+                            orientedCorner(sourceTwin, true),
+                            orientedCorner(destinationTwin, true)
+                        ));
+                    } else if (dst.cornerVertex(dst.nextCorner(destinationTwin)) == expected) {
+                        pending.push_back(std::make_pair(
+                            orientedCorner(sourceTwin, true),
+                            orientedCorner(dst.nextCorner(destinationTwin), false)
+                        ));
+                    } else {
+                        result = false;
+                    }
+                }
+
+                sourceCorner = sourceOther;
+                destinationCorner = destinationOther;
+            }
+        }
+
+        return result && matchedFaces == shellSize;
+    }
+}
+
+
+bool polyReorder::findCorrespondence(
+    const MeshData &source,
+    std::vector<ComponentSelection> &sourceComponents,
+    const MeshData &destination,
+    std::vector<ComponentSelection> &destinationComponents,
+    int numberOfThreads
+) {
+    numberOfThreads = resolveThreadCount(numberOfThreads);
+
+    Shells sourceShells;
+    Shells destinationShells;
+
+    getShells(source, sourceShells);
+    getShells(destination, destinationShells);
+
+    std::vector<uint64_t> sourceSignatures;
+    std::vector<uint64_t> destinationSignatures;
+
+    getCornerSignatures(source, numberOfThreads, sourceSignatures);
+    getCornerSignatures(destination, numberOfThreads, destinationSignatures);
+
+    int numberOfOriented = (int) destinationSignatures.size();
+
+    int numberOfBuckets = 1;
+
+    while (numberOfBuckets < numberOfOriented && numberOfBuckets < MAX_SIGNATURE_BUCKETS)
+    {
+        numberOfBuckets <<= 1;
+    }
+
+    uint64_t bucketMask = uint64_t(numberOfBuckets - 1);
+
+    std::vector<int> sourceSeeds;
+
+    if (sourceComponents.empty())
+    {
+        std::vector<int> bucketCounts(numberOfBuckets, 0);
+
+        for (uint64_t signature : destinationSignatures)
+        {
+            bucketCounts[signature & bucketMask]++;
+        }
+
+        int numberOfShells = (int) sourceShells.shellSize.size();
+
+        std::vector<int> bestCount(numberOfShells, INT_MAX);
+        sourceSeeds.assign(numberOfShells, -1);
+
+        for (int oriented = 0; oriented < (int) sourceSignatures.size(); oriented++)
+        {
+            int shell = sourceShells.faceShell[source.cornerFace(cornerOf(oriented))];
+            int count = bucketCounts[sourceSignatures[oriented] & bucketMask];
+
+            if (count < bestCount[shell])
+            {
+                bestCount[shell] = count;
+                sourceSeeds[shell] = oriented;
+            }
+        }
+
+        sourceComponents.resize(numberOfShells);
+
+        for (int shell = 0; shell < numberOfShells; shell++)
+        {
+            int corner = cornerOf(sourceSeeds[shell]);
+
+            sourceComponents[shell].faceIndex = source.cornerFace(corner);
+            sourceComponents[shell].edgeIndex = orientedEdge(source, sourceSeeds[shell]);
+            sourceComponents[shell].vertexIndex = source.cornerVertex(corner);
+        }
+    } else {
+        for (ComponentSelection &cs : sourceComponents)
+        {
+            int corner = source.findCorner(cs.faceIndex, cs.edgeIndex);
+
+            if (corner == -1)
+            {
+                sourceSeeds.push_back(-1);
+            } else if (source.cornerVertex(corner) == cs.vertexIndex) {
+                sourceSeeds.push_back(orientedCorner(corner, true));
+            } else {
+                sourceSeeds.push_back(orientedCorner(source.nextCorner(corner), false));
+            }
+        }
+    }
+
+    std::vector<uint64_t> seedSignatures;
+
+    for (int oriented : sourceSeeds)
+    {
+        if (oriented != -1) { seedSignatures.push_back(sourceSignatures[oriented]); }
+    }
+
+    std::sort(seedSignatures.begin(), seedSignatures.end());
+    seedSignatures.erase(std::unique(seedSignatures.begin(), seedSignatures.end()), seedSignatures.end());
+
+    std::vector<char> seedBuckets(numberOfBuckets, 0);
+
+    for (uint64_t signature : seedSignatures)
+    {
+        seedBuckets[signature & bucketMask] = 1;
+    }
+
+    std::vector<std::vector<int>> candidates(seedSignatures.size());
+
+    for (int oriented = 0; oriented < numberOfOriented; oriented++)
+    {
+        uint64_t signature = destinationSignatures[oriented];
+
+        if (!seedBuckets[signature & bucketMask]) { continue; }
+
+        auto it = std::lower_bound(seedSignatures.begin(), seedSignatures.end(), signature);
+
+        if (it != seedSignatures.end() && *it == signature)
+        {
+            candidates[it - seedSignatures.begin()].push_back(oriented);
+        }
+    }
+
+    int numberOfSelections = (int) sourceSeeds.size();
+
+    destinationComponents.resize(numberOfSelections);
+
+    std::vector<ShellMatcher> matchers(numberOfThreads);
+
+    for (ShellMatcher &matcher : matchers)
+    {
+        matcher.init(source, destination);
+    }
+
+    std::vector<char> destinationShellUsed(destinationShells.shellSize.size(), 0);
+
+    bool result = true;
+
+    for (int i = 0; i < numberOfSelections; i++)
+    {
+        ComponentSelection &match = destinationComponents[i];
+
+        match.faceIndex = match.edgeIndex = match.vertexIndex = -1;
+
+        int sourceOriented = sourceSeeds[i];
+
+        if (sourceOriented == -1)
+        {
+            result = false;
+            continue;
+        }
+
+        int sourceShell = sourceShells.faceShell[source.cornerFace(cornerOf(sourceOriented))];
+        int shellSize = sourceShells.shellSize[sourceShell];
+
+        auto signature = std::lower_bound(seedSignatures.begin(), seedSignatures.end(), sourceSignatures[sourceOriented]);
+
+        std::vector<int> shellCandidates;
+
+        for (int oriented : candidates[signature - seedSignatures.begin()])
+        {
+            int destinationShell = destinationShells.faceShell[destination.cornerFace(cornerOf(oriented))];
+
+            if (!destinationShellUsed[destinationShell] && destinationShells.shellSize[destinationShell] == shellSize)
+            {
+                shellCandidates.push_back(oriented);
+            }
+        }
+
+        int numberOfCandidates = (int) shellCandidates.size();
+        bool runParallel = (long long) numberOfCandidates * shellSize >= PARALLEL_MATCH_WORK;
+
+        std::atomic<int> nextCandidate(0);
+        std::atomic<int> bestCandidate(INT_MAX);
+
+        parallelFor(runParallel ? numberOfThreads : 1, numberOfThreads, [&](int thread)
+        {
+            ShellMatcher &matcher = matchers[thread];
+
+            for (int c = nextCandidate++; c < numberOfCandidates; c = nextCandidate++)
+            {
+                if (c > bestCandidate.load()) { break; }
+
+                bool matched = matcher.match(sourceOriented, shellCandidates[c], shellSize);
+                matcher.clear();
+
+                if (matched)
+                {
+                    int best = bestCandidate.load();
+
+                    while (c < best && !bestCandidate.compare_exchange_weak(best, c)) {}
+
+                    break;
+                }
+            }
+        });
+
+        if (bestCandidate.load() == INT_MAX)
+        {
+            result = false;
+            continue;
+        }
+
+        int destinationOriented = shellCandidates[bestCandidate.load()];
+        int destinationCorner = cornerOf(destinationOriented);
+
+        match.faceIndex = destination.cornerFace(destinationCorner);
+        match.edgeIndex = orientedEdge(destination, destinationOriented);
+        match.vertexIndex = destination.cornerVertex(destinationCorner);
+
+        destinationShellUsed[destinationShells.faceShell[match.faceIndex]] = 1;
+    }
+
+    return result;
+}
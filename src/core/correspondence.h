@@ -0,0 +1,42 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#ifndef YANTOR3D_CORRESPONDENCE_H
+#define YANTOR3D_CORRESPONDENCE_H
+
+#include "componentSelection.h"
+#include "meshData.h"
+
+#include <vector>
+
+namespace polyReorder
+{
+    /**
+        Finds, for every source selection, the destination selection that a
+        walk can start from to reproduce the source shell exactly.
+
+        If sourceComponents is empty one selection is picked per shell of the
+        source, at the corner whose local signature is rarest on the
+        destination. Candidates are destination corners with the same face
+        degree, end valences, border state and vertex ring signature that sit
+        on a not yet matched shell of the same size. Each candidate is checked
+        by matching the two shells face by face from it, in parallel, and the
+        lowest numbered candidate that matches wins - so the result does not
+        depend on the thread count.
+
+        Returns false if any shell has no match; its destination selection is
+        left at -1. Symmetric shells match more than one way, and any of them
+        may be picked.
+    */
+    bool findCorrespondence(
+        const MeshData &source,
+        std::vector<ComponentSelection> &sourceComponents,
+        const MeshData &destination,
+        std::vector<ComponentSelection> &destinationComponents,
+        int numberOfThreads = 1
+    );
+}
+
+#endif
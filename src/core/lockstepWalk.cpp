@@ -0,0 +1,475 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "componentSelection.h"
+#include "lockstepWalk.h"
+#include "meshData.h"
+#include "meshTopology.h"
+#include "parallel.h"
+#include "progress.h"
+#include "topologyPath.h"
+
+#include <atomic>
+#include <climits>
+#include <vector>
+
+
+LockstepWalk::LockstepWalk(MeshTopology &source, MeshTopology &destination, bool sameIndices) :
+    source(source),
+    destination(destination),
+    sameIndices(sameIndices)
+{}
+
+
+LockstepWalk::~LockstepWalk() {}
+
+
+/**
+    Resets both topologies and walks every pair of selections in order. With
+    more than one thread, selections are grouped so that no two groups share a
+    vertex-connected piece of either mesh, and each group is walked on its own
+    thread as in MeshTopology::walk(). The mismatch reported is always the one
+    a single-threaded walk would have stopped at.
+*/
+bool LockstepWalk::walk(
+    std::vector<polyReorder::ComponentSelection> &sourceComponents,
+    std::vector<polyReorder::ComponentSelection> &destinationComponents,
+    int numberOfThreads,
+    Progress *progress
+) {
+    firstMismatch = polyReorder::WalkMismatch();
+
+    this->progress = progress;
+
+    source.reset();
+    destination.reset();
+
+    polyReorder::beginPhase(progress, "walkMeshes", (size_t) source.numberOfEdges());
+
+    int numberOfShells = (int) sourceComponents.size();
+
+    if (numberOfShells != (int) destinationComponents.size())
+    {
+        return false;
+    }
+
+    numberOfThreads = polyReorder::resolveThreadCount(numberOfThreads);
+
+    if (numberOfThreads == 1 || numberOfShells < 2)
+    {
+        polyReorder::WalkMismatch shellMismatch;
+
+        for (int i = 0; i < numberOfShells; i++)
+        {
+            source.serialWalk.shellId = i;
+            destination.serialWalk.shellId = i;
+
+            if (!walkShell(sourceComponents[i], destinationComponents[i], source.serialWalk, destination.serialWalk, shellMismatch))
+            {
+                if (polyReorder::isCancelled(progress)) { return false; }
+
+                firstMismatch = shellMismatch;
+                firstMismatch.selection = i;
+                return false;
+            }
+        }
+
+        source.serialWalk.shellId = numberOfShells;
+        destination.serialWalk.shellId = numberOfShells;
+
+        return true;
+    }
+
+    std::vector<int> sourcePieces;
+    std::vector<int> destinationPieces;
+
+    source.getPieces(sourceComponents, sourcePieces);
+    destination.getPieces(destinationComponents, destinationPieces);
+
+    std::vector<int> root(numberOfShells);
+
+    for (int i = 0; i < numberOfShells; i++)
+    {
+        root[i] = i;
+    }
+
+    auto find = [&root](int i)
+    {
+        while (root[i] != i)
+        {
+            root[i] = root[root[i]];
+            i = root[i];
+        }
+
+        return i;
+    };
+
+    auto unite = [&root, &find](int a, int b)
+    {
+        a = find(a);
+        b = find(b);
+
+        if (a < b) { root[b] = a; } else if (b < a) { root[a] = b; }
+    };
+
+    std::vector<int> sourcePieceShell(source.numberOfVertices(), -1);
+    std::vector<int> destinationPieceShell(destination.numberOfVertices(), -1);
+
+    for (int i = 0; i < numberOfShells; i++)
+    {
+        int &sourceShell = sourcePieceShell[sourcePieces[sourceComponents[i].vertexIndex]];
+        int &destinationShell = destinationPieceShell[destinationPieces[destinationComponents[i].vertexIndex]];
+
+        if (sourceShell != -1) { unite(sourceShell, i); }
+        if (destinationShell != -1) { unite(destinationShell, i); }
+
+        sourceShell = i;
+        destinationShell = i;
+    }
+
+    std::vector<int> rootGroup(numberOfShells, -1);
+    std::vector<int> shellGroup(numberOfShells);
+    std::vector<int> shellIndex(numberOfShells);
+
+    int numberOfGroups = 0;
+
+    for (int i = 0; i < numberOfShells; i++)
+    {
+        int r = find(i);
+
+        if (rootGroup[r] == -1)
+        {
+            rootGroup[r] = numberOfGroups++;
+        }
+
+        shellGroup[i] = rootGroup[r];
+        shellIndex[i] = i;
+    }
+
+    std::vector<int> sourcePieceGroup(source.numberOfVertices(), -1);
+    std::vector<int> destinationPieceGroup(destination.numberOfVertices(), -1);
+
+    for (int i = 0; i < numberOfShells; i++)
+    {
+        sourcePieceGroup[sourcePieces[sourceComponents[i].vertexIndex]] = shellGroup[i];
+        destinationPieceGroup[destinationPieces[destinationComponents[i].vertexIndex]] = shellGroup[i];
+    }
+
+    AdjacencyList groupShells;
+    groupShells.build(numberOfGroups, numberOfShells, shellGroup, shellIndex);
+
+    std::vector<ShellWalk> sourceWalks(numberOfGroups);
+    std::vector<ShellWalk> destinationWalks(numberOfGroups);
+
+    source.getGroupWalks(sourcePieces, sourcePieceGroup, sourceWalks);
+    destination.getGroupWalks(destinationPieces, destinationPieceGroup, destinationWalks);
+
+    ShellSegments sourceSegments(numberOfShells);
+    ShellSegments destinationSegments(numberOfShells);
+
+    std::vector<polyReorder::WalkMismatch> groupMismatches(numberOfGroups);
+    std::atomic<int> firstFailure(INT_MAX);
+
+    polyReorder::parallelFor(numberOfGroups, numberOfThreads, [&](int g)
+    {
+        for (int i : groupShells[g])
+        {
+            if (i > firstFailure.load()) { break; }
+
+            source.beginShell(i, sourceWalks[g], sourceSegments);
+            destination.beginShell(i, destinationWalks[g], destinationSegments);
+
+            bool matched = walkShell(
+                sourceComponents[i],
+                destinationComponents[i],
+                sourceWalks[g],
+                destinationWalks[g],
+                groupMismatches[g]
+            );
+
+            source.endShell(i, sourceWalks[g], sourceSegments);
+            destination.endShell(i, destinationWalks[g], destinationSegments);
+
+            if (!matched)
+            {
+                groupMismatches[g].selection = i;
+
+                int failure = firstFailure.load();
+
+                while (i < failure && !firstFailure.compare_exchange_weak(failure, i)) {}
+
+                break;
+            }
+        }
+    });
+
+    if (polyReorder::isCancelled(progress))
+    {
+        return false;
+    }
+
+    if (firstFailure.load() != INT_MAX)
+    {
+        firstMismatch = groupMismatches[shellGroup[firstFailure.load()]];
+        return false;
+    }
+
+    source.collect(sourceSegments);
+    destination.collect(destinationSegments);
+
+    return true;
+}
+
+
+bool LockstepWalk::walkShell(
+    polyReorder::ComponentSelection &sourceStart,
+    polyReorder::ComponentSelection &destinationStart,
+    ShellWalk &sourceWalk,
+    ShellWalk &destinationWalk,
+    polyReorder::WalkMismatch &mismatch
+) {
+    MeshData &sourceData = source.meshData;
+    MeshData &destinationData = destination.meshData;
+
+    int shellId = sourceWalk.shellId;
+
+    mismatch.sourceFace = sourceStart.faceIndex;
+    mismatch.sourceVertex = sourceStart.vertexIndex;
+    mismatch.destinationFace = destinationStart.faceIndex;
+    mismatch.destinationVertex = destinationStart.vertexIndex;
+
+    bool startMatches = (
+           visitBoth(source.vertexPath, sourceWalk.vertices, sourceStart.vertexIndex,
+                     destination.vertexPath, destinationWalk.vertices, destinationStart.vertexIndex, shellId)
+        && visitBoth(source.edgePath, sourceWalk.edges, sourceStart.edgeIndex,
+                     destination.edgePath, destinationWalk.edges, destinationStart.edgeIndex, shellId)
+        && source.facePath.visited(sourceStart.faceIndex) == destination.facePath.visited(destinationStart.faceIndex)
+    );
+
+    if (!startMatches) { return false; }
+
+    if (!source.facePath.visited(sourceStart.faceIndex))
+    {
+        if (!walkFaces(sourceStart.faceIndex, destinationStart.faceIndex, sourceWalk, destinationWalk, mismatch))
+        {
+            return false;
+        }
+    }
+
+    while (!source.edgePath.empty(sourceWalk.edges))
+    {
+        if (!polyReorder::checkpoint(progress, sourceWalk.steps++)) { return false; }
+        if (destination.edgePath.empty(destinationWalk.edges)) { return false; }
+
+        int sourceEdge = source.edgePath.next(sourceWalk.edges);
+        int destinationEdge = destination.edgePath.next(destinationWalk.edges);
+
+        IndexRange sourceFaces = sourceData.edgeFaces(sourceEdge);
+        IndexRange destinationFaces = destinationData.edgeFaces(destinationEdge);
+
+        if (sourceFaces.size() != destinationFaces.size())
+        {
+            mismatch.sourceFace = sourceFaces[0];
+            mismatch.sourceVertex = sourceData.edgeVertices(sourceEdge)[0];
+            mismatch.destinationFace = destinationFaces[0];
+            mismatch.destinationVertex = destinationData.edgeVertices(destinationEdge)[0];
+
+            return false;
+        }
+
+        int j = 0;
+
+        for (int sourceFace : sourceFaces)
+        {
+            if (source.facePath.visited(sourceFace)) { continue; }
+
+            int destinationFace = -1;
+
+            while (j < destinationFaces.size())
+            {
+                int faceIndex = destinationFaces[j++];
+
+                if (!destination.facePath.visited(faceIndex))
+                {
+                    destinationFace = faceIndex;
+                    break;
+                }
+            }
+
+            if (destinationFace == -1)
+            {
+                mismatch.sourceFace = sourceFace;
+                mismatch.sourceVertex = -1;
+                mismatch.destinationFace = destinationFaces[0];
+                mismatch.destinationVertex = -1;
+
+                return false;
+            }
+
+            if (!walkFaces(sourceFace, destinationFace, sourceWalk, destinationWalk, mismatch))
+            {
+                return false;
+            }
+        }
+
+        for (; j < destinationFaces.size(); j++)
+        {
+            int faceIndex = destinationFaces[j];
+
+            if (!destination.facePath.visited(faceIndex))
+            {
+                mismatch.sourceFace = sourceFaces[0];
+                mismatch.sourceVertex = -1;
+                mismatch.destinationFace = faceIndex;
+                mismatch.destinationVertex = -1;
+
+                return false;
+            }
+        }
+    }
+
+    return destination.edgePath.empty(destinationWalk.edges);
+}
+
+
+bool LockstepWalk::walkFaces(
+    int sourceFace,
+    int destinationFace,
+    ShellWalk &sourceWalk,
+    ShellWalk &destinationWalk,
+    polyReorder::WalkMismatch &mismatch
+) {
+    MeshData &sourceData = source.meshData;
+    MeshData &destinationData = destination.meshData;
+
+    int shellId = sourceWalk.shellId;
+
+    mismatch.sourceFace = sourceFace;
+    mismatch.sourceVertex = -1;
+    mismatch.destinationFace = destinationFace;
+    mismatch.destinationVertex = -1;
+
+    if (sourceData.faceSize(sourceFace) != destinationData.faceSize(destinationFace))
+    {
+        return false;
+    }
+
+    if (sameIndices && sourceFace != destinationFace)
+    {
+        return false;
+    }
+
+    int sourceEdge = source.getFirstVisited(sourceData.faceEdges(sourceFace), source.edgePath);
+    int destinationEdge = destination.getFirstVisited(destinationData.faceEdges(destinationFace), destination.edgePath);
+
+    if (sourceEdge == -1 || destinationEdge == -1)
+    {
+        return false;
+    }
+
+    int sourceVertex = source.getFirstVisited(sourceData.edgeVertices(sourceEdge), source.vertexPath);
+    int destinationVertex = destination.getFirstVisited(destinationData.edgeVertices(destinationEdge), destination.vertexPath);
+
+    mismatch.sourceVertex = sourceVertex;
+    mismatch.destinationVertex = destinationVertex;
+
+    bool entryMatches = (
+           source.edgePath.visitedAt(sourceEdge) - sourceWalk.edges.visitBase
+        == destination.edgePath.visitedAt(destinationEdge) - destinationWalk.edges.visitBase
+        && source.vertexPath.visitedAt(sourceVertex) - sourceWalk.vertices.visitBase
+        == destination.vertexPath.visitedAt(destinationVertex) - destinationWalk.vertices.visitBase
+    );
+
+    if (!entryMatches) { return false; }
+
+    int sourceCorner = sourceData.findCorner(sourceFace, sourceEdge);
+    int destinationCorner = destinationData.findCorner(destinationFace, destinationEdge);
+
+    bool sourceForward = sourceData.cornerVertex(sourceCorner) == sourceVertex;
+    bool destinationForward = destinationData.cornerVertex(destinationCorner) == destinationVertex;
+
+    int firstSourceCorner = sourceForward ? sourceCorner : sourceData.nextCorner(sourceCorner);
+    int firstDestinationCorner = destinationForward ? destinationCorner : destinationData.nextCorner(destinationCorner);
+
+    sourceCorner = firstSourceCorner;
+    destinationCorner = firstDestinationCorner;
+
+    do
+    {
+        if (sourceForward)
+        {
+            sourceEdge = sourceData.cornerEdge(sourceCorner);
+            sourceCorner = sourceData.nextCorner(sourceCorner);
+        } else {
+            sourceCorner = sourceData.prevCorner(sourceCorner);
+            sourceEdge = sourceData.cornerEdge(sourceCorner);
+        }
+
+        if (destinationForward)
+        {
+            destinationEdge = destinationData.cornerEdge(destinationCorner);
+            destinationCorner = destinationData.nextCorner(destinationCorner);
+        } else {
+            destinationCorner = destinationData.prevCorner(destinationCorner);
+            destinationEdge = destinationData.cornerEdge(destinationCorner);
+        }
+
+        sourceVertex = sourceData.cornerVertex(sourceCorner);
+        destinationVertex = destinationData.cornerVertex(destinationCorner);
+
+        mismatch.sourceVertex = sourceVertex;
+        mismatch.destinationVertex = destinationVertex;
+
+        bool stepMatches = (
+               visitBoth(source.vertexPath, sourceWalk.vertices, sourceVertex,
+                         destination.vertexPath, destinationWalk.vertices, destinationVertex, shellId)
+            && visitBoth(source.edgePath, sourceWalk.edges, sourceEdge,
+                         destination.edgePath, destinationWalk.edges, destinationEdge, shellId)
+        );
+
+        if (!stepMatches) { return false; }
+
+        source.edgePath.push(sourceEdge, sourceWalk.edges);
+        destination.edgePath.push(destinationEdge, destinationWalk.edges);
+    } while (sourceCorner != firstSourceCorner);
+
+    source.facePath.visit(sourceFace, shellId, sourceWalk.faces);
+    destination.facePath.visit(destinationFace, shellId, destinationWalk.faces);
+
+    return true;
+}
+
+
+/**
+    Visits one component on each mesh and checks they agree - either both are
+    new, or both were first visited at the same step of their walk.
+*/
+bool LockstepWalk::visitBoth(
+    TopologyPath &sourcePath,
+    PathCursor &sourceCursor,
+    int sourceIndex,
+    TopologyPath &destinationPath,
+    PathCursor &destinationCursor,
+    int destinationIndex,
+    int shellId
+) {
+    if (sameIndices && sourceIndex != destinationIndex)
+    {
+        return false;
+    }
+
+    bool sourceIsNew = sourcePath.visit(sourceIndex, shellId, sourceCursor);
+    bool destinationIsNew = destinationPath.visit(destinationIndex, shellId, destinationCursor);
+
+    if (sourceIsNew != destinationIsNew)
+    {
+        return false;
+    }
+
+    return (
+           sourcePath.visitedAt(sourceIndex) - sourceCursor.visitBase
+        == destinationPath.visitedAt(destinationIndex) - destinationCursor.visitBase
+    );
+}
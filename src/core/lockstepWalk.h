@@ -0,0 +1,106 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#ifndef YANTOR3D_LOCKSTEP_WALK_H
+#define YANTOR3D_LOCKSTEP_WALK_H
+
+#include "componentSelection.h"
+#include "meshTopology.h"
+#include "progress.h"
+#include "topologyPath.h"
+
+#include <vector>
+
+namespace polyReorder
+{
+    /**
+        Where a lockstep walk found the two meshes to disagree - the selection
+        it was walking from, and the face and vertex reached on each mesh. The
+        vertex is -1 when the faces themselves do not match.
+    */
+    struct WalkMismatch
+    {
+        int     selection           = -1;
+
+        int     sourceFace          = -1;
+        int     sourceVertex        = -1;
+
+        int     destinationFace     = -1;
+        int     destinationVertex   = -1;
+    };
+}
+
+/**
+    Walks a source and a destination topology together, one step at a time.
+    Every face pair must have the same degree, and every vertex and edge pair
+    must either both be new or both have been visited at the same step. The
+    walk stops at the first step where they are not, so a bad seed or a
+    mismatched mesh costs as much as the part that matched.
+
+    When both walks finish, each topology holds exactly the visit order its
+    own MeshTopology::walk() would have produced.
+
+    With sameIndices set, every pair must also be the same index on both
+    meshes, so the walk stops as soon as the two meshes' orders differ.
+
+    A walk given a progress also stops when that is cancelled, and reports
+    no mismatch.
+*/
+class LockstepWalk
+{
+public:
+                        LockstepWalk(MeshTopology &source, MeshTopology &destination, bool sameIndices=false);
+    virtual             ~LockstepWalk();
+
+    bool                walk(
+                            std::vector<polyReorder::ComponentSelection> &sourceComponents, 
+                            std::vector<polyReorder::ComponentSelection> &destinationComponents, 
+                            int numberOfThreads = 1,
+                            Progress *progress = nullptr
+                        );
+
+    const polyReorder::WalkMismatch&    mismatch() const { return firstMismatch; }
+
+private:
+    typedef MeshTopology::ShellWalk     ShellWalk;
+    typedef MeshTopology::ShellSegments ShellSegments;
+
+    bool                walkShell(
+                            polyReorder::ComponentSelection &sourceStart, 
+                            polyReorder::ComponentSelection &destinationStart, 
+                            ShellWalk &sourceWalk, 
+                            ShellWalk &destinationWalk, 
+                            polyReorder::WalkMismatch &mismatch
+                        );
+
+    bool                walkFaces(
+                            int sourceFace, 
+                            int destinationFace, 
+                            ShellWalk &sourceWalk, 
+                            ShellWalk &destinationWalk, 
+                            polyReorder::WalkMismatch &mismatch
+                        );
+
+    bool                visitBoth(
+                            TopologyPath &sourcePath, 
+                            PathCursor &sourceCursor, 
+                            int sourceIndex, 
+                            TopologyPath &destinationPath, 
+                            PathCursor &destinationCursor, 
+                            int destinationIndex, 
+                            int shellId
+                        );
+
+private:
+    MeshTopology                &source;
+    MeshTopology                &destination;
+
+    bool                        sameIndices;
+    Progress                    *progress = nullptr;
+
+    polyReorder::WalkMismatch   firstMismatch;
+};
+
+#endif
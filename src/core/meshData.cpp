@@ -0,0 +1,319 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "meshData.h"
+
+#include <algorithm>
+#include <vector>
+
+
+void AdjacencyList::clear()
+{
+    offsets.clear();
+    indices.clear();
+}
+
+
+void AdjacencyList::build(int numberOfRows, int numberOfColumns, const std::vector<int> &rows, const std::vector<int> &columns)
+{
+    int numberOfPairs = (int) rows.size();
+
+    std::vector<int> byColumn(numberOfPairs);
+    std::vector<int> counts(std::max(numberOfRows, numberOfColumns) + 1, 0);
+
+    for (int c : columns) { counts[c + 1]++; }
+    for (int i = 0; i < numberOfColumns; i++) { counts[i + 1] += counts[i]; }
+    for (int p = 0; p < numberOfPairs; p++) { byColumn[counts[columns[p]]++] = p; }
+
+    offsets.assign(numberOfRows + 1, 0);
+    indices.resize(numberOfPairs);
+
+    for (int r : rows) { offsets[r + 1]++; }
+    for (int i = 0; i < numberOfRows; i++) { offsets[i + 1] += offsets[i]; }
+
+    counts.assign(offsets.begin(), offsets.end() - 1);
+
+    for (int p : byColumn) { indices[counts[rows[p]]++] = columns[p]; }
+
+    int numberOfIndices = 0;
+
+    for (int r = 0; r < numberOfRows; r++)
+    {
+        int rowStart = numberOfIndices;
+
+        for (int i = offsets[r]; i < offsets[r + 1]; i++)
+        {
+            if (numberOfIndices == rowStart || indices[numberOfIndices - 1] != indices[i])
+            {
+                indices[numberOfIndices++] = indices[i];
+            }
+        }
+
+        offsets[r] = rowStart;
+    }
+
+    offsets[numberOfRows] = numberOfIndices;
+    indices.resize(numberOfIndices);
+    indices.shrink_to_fit();
+}
+
+
+size_t AdjacencyList::memoryUsage() const
+{
+    return (offsets.capacity() + indices.capacity()) * sizeof(int);
+}
+
+
+MeshData::MeshData() {}
+
+
+MeshData::~MeshData() {}
+
+
+void MeshData::clear()
+{
+    numberOfVertices = 0;
+    numberOfEdges = 0;
+    numberOfFaces = 0;
+
+    vertexEdgeList.clear();
+    vertexFaceList.clear();
+    vertexVertexList.clear();
+
+    edgeVertexList.clear();
+    edgeFaceList.clear();
+    edgeEdgeList.clear();
+
+    faceEdgeList.clear();
+    faceVertexList.clear();
+
+    numberOfCorners = 0;
+
+    faceCornerOffsets.clear();
+    cornerVertices.clear();
+    cornerFaces.clear();
+    cornerEdges.clear();
+    cornerNext.clear();
+    cornerPrev.clear();
+    cornerTwin.clear();
+}
+
+
+bool MeshData::unpackMesh(
+    int numVertices, 
+    const std::vector<int> &polyCounts, 
+    const std::vector<int> &polyConnects, 
+    const std::vector<int> &edgeVertices, 
+    Progress *progress
+) {
+    this->clear();
+
+    this->numberOfVertices = numVertices;
+    this->numberOfEdges = (int) edgeVertices.size() / 2;
+    this->numberOfFaces = (int) polyCounts.size();
+
+    this->numberOfCorners = (int) polyConnects.size();
+
+    int step = 0;
+
+    polyReorder::beginPhase(progress, "unpackMesh", size_t(numberOfFaces) + size_t(numberOfCorners) + size_t(numberOfEdges));
+
+    std::vector<int> rows;
+    std::vector<int> columns;
+
+    rows.reserve(std::max(numberOfCorners * 2, numberOfEdges * 2));
+    columns.reserve(std::max(numberOfCorners * 2, numberOfEdges * 2));
+
+    for (int e = 0; e < numberOfEdges; e++)
+    {
+        rows.push_back(e);
+        columns.push_back(edgeVertices[e * 2]);
+        rows.push_back(e);
+        columns.push_back(edgeVertices[e * 2 + 1]);
+    }
+
+    edgeVertexList.build(numberOfEdges, numberOfVertices, rows, columns);
+    vertexEdgeList.build(numberOfVertices, numberOfEdges, columns, rows);
+
+    for (int p = 0; p < numberOfEdges * 2; p++)
+    {
+        rows[p] = edgeVertices[p];
+        columns[p] = edgeVertices[p ^ 1];
+    }
+
+    vertexVertexList.build(numberOfVertices, numberOfVertices, rows, columns);
+
+    if (polyReorder::isCancelled(progress))
+    {
+        this->clear();
+        return false;
+    }
+
+    faceCornerOffsets.resize(numberOfFaces + 1);
+    cornerVertices = polyConnects;
+    cornerFaces.resize(numberOfCorners);
+    cornerEdges.assign(numberOfCorners, -1);
+    cornerNext.resize(numberOfCorners);
+    cornerPrev.resize(numberOfCorners);
+    cornerTwin.assign(numberOfCorners, -1);
+
+    faceCornerOffsets[0] = 0;
+
+    for (int f = 0, c = 0; f < numberOfFaces; f++)
+    {
+        if (!polyReorder::checkpoint(progress, step++))
+        {
+            this->clear();
+            return false;
+        }
+
+        int faceStart = c;
+        int faceSize = polyCounts[f];
+
+        for (int i = 0; i < faceSize; i++, c++)
+        {
+            cornerFaces[c] = f;
+            cornerNext[c] = faceStart + (i + 1) % faceSize;
+            cornerPrev[c] = faceStart + (i + faceSize - 1) % faceSize;
+        }
+
+        faceCornerOffsets[f + 1] = c;
+    }
+
+    faceVertexList.build(numberOfFaces, numberOfVertices, cornerFaces, polyConnects);
+    vertexFaceList.build(numberOfVertices, numberOfFaces, polyConnects, cornerFaces);
+
+    rows.clear();
+    columns.clear();
+
+    for (int c = 0; c < numberOfCorners; c++)
+    {
+        if (!polyReorder::checkpoint(progress, step++))
+        {
+            this->clear();
+            return false;
+        }
+
+        int nextVertex = cornerVertices[cornerNext[c]];
+
+        for (int e : vertexEdges(cornerVertices[c]))
+        {
+            IndexRange ev = this->edgeVertices(e);
+
+            if (ev[0] == nextVertex || ev[1] == nextVertex)
+            {
+                cornerEdges[c] = e;
+                break;
+            }
+        }
+
+        if (cornerEdges[c] != -1)
+        {
+            rows.push_back(cornerEdges[c]);
+            columns.push_back(c);
+        }
+    }
+
+    AdjacencyList edgeCornerList;
+    edgeCornerList.build(numberOfEdges, numberOfCorners, rows, columns);
+
+    for (int e = 0; e < numberOfEdges; e++)
+    {
+        IndexRange corners = edgeCornerList[e];
+
+        if (corners.size() > 1)
+        {
+            cornerTwin[corners[0]] = corners[1];
+
+            for (int i = 1; i < corners.size(); i++)
+            {
+                cornerTwin[corners[i]] = corners[0];
+            }
+        }
+    }
+
+    for (int p = 0; p < (int) rows.size(); p++)
+    {
+        int c = columns[p];
+
+        columns[p] = rows[p];
+        rows[p] = cornerFaces[c];
+    }
+
+    faceEdgeList.build(numberOfFaces, numberOfEdges, rows, columns);
+    edgeFaceList.build(numberOfEdges, numberOfFaces, columns, rows);
+
+    rows.clear();
+    columns.clear();
+
+    for (int e = 0; e < numberOfEdges; e++)
+    {
+        if (!polyReorder::checkpoint(progress, step++))
+        {
+            this->clear();
+            return false;
+        }
+
+        for (int v : this->edgeVertices(e))
+        {
+            for (int o : vertexEdges(v))
+            {
+                if (o != e)
+                {
+                    rows.push_back(e);
+                    columns.push_back(o);
+                }
+            }
+        }
+    }
+
+    edgeEdgeList.build(numberOfEdges, numberOfEdges, rows, columns);
+
+    return true;
+}
+
+
+int MeshData::findCorner(int faceIndex, int edgeIndex) const
+{
+    for (int c = faceCornerOffsets[faceIndex]; c < faceCornerOffsets[faceIndex + 1]; c++)
+    {
+        if (cornerEdges[c] == edgeIndex)
+        {
+            return c;
+        }
+    }
+
+    return -1;
+}
+
+
+size_t MeshData::memoryUsage() const
+{
+    return (
+          vertexEdgeList.memoryUsage()
+        + vertexFaceList.memoryUsage()
+        + vertexVertexList.memoryUsage()
+        + edgeVertexList.memoryUsage()
+        + edgeFaceList.memoryUsage()
+        + edgeEdgeList.memoryUsage()
+        + faceEdgeList.memoryUsage()
+        + faceVertexList.memoryUsage()
+        + (
+              faceCornerOffsets.capacity()
+            + cornerVertices.capacity()
+            + cornerFaces.capacity()
+            + cornerEdges.capacity()
+            + cornerNext.capacity()
+            + cornerPrev.capacity()
+            + cornerTwin.capacity()
+        ) * sizeof(int)
+    );
+}
+
+
+bool contains(const IndexRange &items, int item)
+{
+    return std::binary_search(items.begin(), items.end(), item);
+}
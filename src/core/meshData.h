@@ -0,0 +1,145 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#ifndef MESH_DATA_CMD_H
+#define MESH_DATA_CMD_H
+
+#include "progress.h"
+
+#include <cstddef>
+#include <vector>
+
+
+/**
+    Read-only view of one row of an AdjacencyList.
+*/
+class IndexRange
+{
+public:
+                    IndexRange() {}
+                    IndexRange(const int *first, const int *last) : first(first), last(last) {}
+
+    const int*      begin() const { return first; }
+    const int*      end() const { return last; }
+
+    int             size() const { return (int) (last - first); }
+    bool            empty() const { return first == last; }
+
+    int             operator[] (int i) const { return first[i]; }
+
+private:
+    const int       *first = nullptr;
+    const int       *last = nullptr;
+};
+
+
+/**
+    Compressed sparse row storage for one component relation - row i owns
+    indices[offsets[i]] to indices[offsets[i + 1]].
+
+    build() takes the relation as parallel (row, column) arrays and sorts it
+    with two stable counting sorts, so every row comes out sorted and free of
+    duplicates in linear time.
+*/
+class AdjacencyList
+{
+public:
+    void            clear();
+    void            build(int numberOfRows, int numberOfColumns, const std::vector<int> &rows, const std::vector<int> &columns);
+
+    int             numberOfRows() const { return offsets.empty() ? 0 : (int) offsets.size() - 1; }
+    size_t          memoryUsage() const;
+
+    IndexRange      operator[] (int row) const
+                    {
+                        return IndexRange(indices.data() + offsets[row], indices.data() + offsets[row + 1]);
+                    }
+
+public:
+    std::vector<int>    offsets;
+    std::vector<int>    indices;
+};
+
+
+class MeshData
+{
+public:
+                            MeshData();
+    virtual                 ~MeshData();
+
+    virtual void            clear();
+
+    /**
+        Builds every adjacency of the mesh. Returns false, with the data
+        cleared, if progress is cancelled part way.
+    */
+    virtual bool            unpackMesh(
+                                int numVertices,
+                                const std::vector<int> &polyCounts,
+                                const std::vector<int> &polyConnects,
+                                const std::vector<int> &edgeVertices,
+                                Progress *progress = nullptr
+                            );
+
+    IndexRange              vertexEdges(int vertexIndex) const      { return vertexEdgeList[vertexIndex]; }
+    IndexRange              vertexFaces(int vertexIndex) const      { return vertexFaceList[vertexIndex]; }
+    IndexRange              vertexVertices(int vertexIndex) const   { return vertexVertexList[vertexIndex]; }
+
+    IndexRange              edgeVertices(int edgeIndex) const       { return edgeVertexList[edgeIndex]; }
+    IndexRange              edgeFaces(int edgeIndex) const          { return edgeFaceList[edgeIndex]; }
+    IndexRange              edgeEdges(int edgeIndex) const          { return edgeEdgeList[edgeIndex]; }
+
+    IndexRange              faceEdges(int faceIndex) const          { return faceEdgeList[faceIndex]; }
+    IndexRange              faceVertices(int faceIndex) const       { return faceVertexList[faceIndex]; }
+
+    int                     faceSize(int faceIndex) const           { return faceCornerOffsets[faceIndex + 1] - faceCornerOffsets[faceIndex]; }
+    int                     faceCorner(int faceIndex) const         { return faceCornerOffsets[faceIndex]; }
+    int                     findCorner(int faceIndex, int edgeIndex) const;
+
+    int                     cornerVertex(int cornerIndex) const     { return cornerVertices[cornerIndex]; }
+    int                     cornerFace(int cornerIndex) const       { return cornerFaces[cornerIndex]; }
+    int                     cornerEdge(int cornerIndex) const       { return cornerEdges[cornerIndex]; }
+    int                     nextCorner(int cornerIndex) const       { return cornerNext[cornerIndex]; }
+    int                     prevCorner(int cornerIndex) const       { return cornerPrev[cornerIndex]; }
+    int                     twinCorner(int cornerIndex) const       { return cornerTwin[cornerIndex]; }
+
+    size_t                  memoryUsage() const;
+
+public:
+    int                             numberOfVertices = 0;
+    int                             numberOfEdges = 0;
+    int                             numberOfFaces = 0;
+    int                             numberOfCorners = 0;
+
+private:
+    AdjacencyList                   vertexEdgeList;
+    AdjacencyList                   vertexFaceList;
+    AdjacencyList                   vertexVertexList;
+
+    AdjacencyList                   edgeVertexList;
+    AdjacencyList                   edgeFaceList;
+    AdjacencyList                   edgeEdgeList;
+
+    AdjacencyList                   faceEdgeList;
+    AdjacencyList                   faceVertexList;
+
+    /**
+        Face-corner table - corner c is the c-th entry of polyConnects. Its
+        edge runs from cornerVertex(c) to cornerVertex(nextCorner(c)), and its
+        twin is the corner on the neighbouring face across that edge, or -1
+        on a border.
+    */
+    std::vector<int>                faceCornerOffsets;
+    std::vector<int>                cornerVertices;
+    std::vector<int>                cornerFaces;
+    std::vector<int>                cornerEdges;
+    std::vector<int>                cornerNext;
+    std::vector<int>                cornerPrev;
+    std::vector<int>                cornerTwin;
+};
+
+bool                contains(const IndexRange &items, int item);
+
+#endif
@@ -0,0 +1,544 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "lockstepWalk.h"
+#include "meshReorder.h"
+#include "meshTopology.h"
+#include "parallel.h"
+#include "progress.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+    const int POINT_CHUNK_SIZE = 1 << 16;
+    const int IDENTITY_BLOCK_SIZE = 1 << 10;
+}
+
+
+bool polyReorder::getPointOrder(
+    MeshTopology &sourceTopology,
+    std::vector<ComponentSelection> &sourceComponents,
+    MeshTopology &destinationTopology,
+    std::vector<ComponentSelection> &destinationComponents,
+    std::vector<int> &pointOrder,
+    int numberOfThreads,
+    WalkMismatch *mismatch,
+    Progress *progress
+) {
+    pointOrder.clear();
+
+    LockstepWalk lockstepWalk(sourceTopology, destinationTopology);
+
+    bool walkSucceeded = lockstepWalk.walk(sourceComponents, destinationComponents, numberOfThreads, progress);
+
+    if (mismatch) { *mismatch = lockstepWalk.mismatch(); }
+
+    if (!walkSucceeded)
+    {
+        return false;
+    }
+
+    if (!sourceTopology.isComplete() || !destinationTopology.isComplete())
+    {
+        return false;
+    }
+
+    int numberOfVertices = sourceTopology.numberOfVertices();
+
+    pointOrder.resize(numberOfVertices);
+
+    for (int i = 0; i < numberOfVertices; i++)
+    {
+        if (destinationTopology[i] == -1 || sourceTopology[i] == -1)
+        {
+            pointOrder.clear();
+            return false;
+        }
+
+        pointOrder[destinationTopology[i]] = sourceTopology[i];
+    }
+
+    return true;
+}
+
+
+bool polyReorder::getWalkedPointOrder(
+    MeshTopology &walkedSource,
+    MeshTopology &destinationTopology,
+    std::vector<ComponentSelection> &destinationComponents,
+    std::vector<int> &pointOrder,
+    ComponentOrder &componentOrder,
+    int numberOfThreads,
+    Progress *progress
+) {
+    pointOrder.clear();
+
+    MeshData &sourceData = walkedSource.data();
+    MeshData &destinationData = destinationTopology.data();
+
+    bool countsMatch = (
+           sourceData.numberOfVertices == destinationData.numberOfVertices
+        && sourceData.numberOfEdges    == destinationData.numberOfEdges
+        && sourceData.numberOfFaces    == destinationData.numberOfFaces
+        && sourceData.numberOfCorners  == destinationData.numberOfCorners
+    );
+
+    if (!countsMatch || !walkedSource.isComplete())
+    {
+        return false;
+    }
+
+    for (ComponentSelection &cs : destinationComponents)
+    {
+        if (!isValidSelection(destinationData, cs)) { return false; }
+    }
+
+    destinationTopology.walk(destinationComponents, numberOfThreads, progress);
+
+    if (!destinationTopology.isComplete())
+    {
+        return false;
+    }
+
+    int numberOfVertices = sourceData.numberOfVertices;
+
+    pointOrder.resize(numberOfVertices);
+
+    for (int i = 0; i < numberOfVertices; i++)
+    {
+        pointOrder[destinationTopology[i]] = walkedSource[i];
+    }
+
+    for (int i = 0; i < sourceData.numberOfEdges; i++)
+    {
+        int sourceEdge = walkedSource.visitedEdge(i);
+        int destinationEdge = destinationTopology.visitedEdge(i);
+
+        if (sourceEdge == -1 || destinationEdge == -1)
+        {
+            pointOrder.clear();
+            return false;
+        }
+
+        IndexRange sourceVertices = sourceData.edgeVertices(sourceEdge);
+        IndexRange destinationVertices = destinationData.edgeVertices(destinationEdge);
+
+        int v0 = pointOrder[destinationVertices[0]];
+        int v1 = pointOrder[destinationVertices[1]];
+
+        bool sameEdge = (
+               (v0 == sourceVertices[0] && v1 == sourceVertices[1])
+            || (v0 == sourceVertices[1] && v1 == sourceVertices[0])
+        );
+
+        if (!sameEdge)
+        {
+            pointOrder.clear();
+            return false;
+        }
+    }
+
+    if (!getComponentOrder(walkedSource, destinationTopology, pointOrder, componentOrder))
+    {
+        pointOrder.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+    Faces and edges were visited at the same steps on both meshes. A face's
+    corners are matched through pointOrder from one shared corner, stepping
+    forwards or backwards to follow the winding of the source face.
+*/
+bool polyReorder::getComponentOrder(
+    MeshTopology &sourceTopology,
+    MeshTopology &destinationTopology,
+    const std::vector<int> &pointOrder,
+    ComponentOrder &componentOrder
+) {
+    MeshData &sourceData = sourceTopology.data();
+    MeshData &destinationData = destinationTopology.data();
+
+    int numberOfEdges = sourceData.numberOfEdges;
+    int numberOfFaces = sourceData.numberOfFaces;
+
+    std::vector<int> &faceOrder = componentOrder.faceOrder;
+    std::vector<int> &edgeOrder = componentOrder.edgeOrder;
+    std::vector<int> &cornerOrder = componentOrder.cornerOrder;
+
+    faceOrder.assign(numberOfFaces, -1);
+    edgeOrder.assign(numberOfEdges, -1);
+    cornerOrder.assign(sourceData.numberOfCorners, -1);
+
+    for (int i = 0; i < numberOfEdges; i++)
+    {
+        int sourceEdge = sourceTopology.visitedEdge(i);
+        int destinationEdge = destinationTopology.visitedEdge(i);
+
+        if (sourceEdge == -1 || destinationEdge == -1) { return false; }
+
+        edgeOrder[destinationEdge] = sourceEdge;
+    }
+
+    for (int i = 0; i < numberOfFaces; i++)
+    {
+        int sourceFace = sourceTopology.visitedFace(i);
+        int destinationFace = destinationTopology.visitedFace(i);
+
+        if (sourceFace == -1 || destinationFace == -1) { return false; }
+
+        faceOrder[destinationFace] = sourceFace;
+
+        int faceSize = sourceData.faceSize(sourceFace);
+        int destinationCorner = destinationData.faceCorner(destinationFace);
+        int firstSourceCorner = sourceData.faceCorner(sourceFace);
+        int sourceCorner = -1;
+
+        for (int c = firstSourceCorner; c < firstSourceCorner + faceSize; c++)
+        {
+            if (sourceData.cornerVertex(c) == pointOrder[destinationData.cornerVertex(destinationCorner)])
+            {
+                sourceCorner = c;
+                break;
+            }
+        }
+
+        if (sourceCorner == -1) { return false; }
+
+        int nextVertex = pointOrder[destinationData.cornerVertex(destinationData.nextCorner(destinationCorner))];
+        bool forward = sourceData.cornerVertex(sourceData.nextCorner(sourceCorner)) == nextVertex;
+
+        for (int k = 0; k < faceSize; k++)
+        {
+            if (sourceData.cornerVertex(sourceCorner) != pointOrder[destinationData.cornerVertex(destinationCorner)])
+            {
+                return false;
+            }
+
+            cornerOrder[destinationCorner] = sourceCorner;
+
+            destinationCorner = destinationData.nextCorner(destinationCorner);
+            sourceCorner = forward ? sourceData.nextCorner(sourceCorner) : sourceData.prevCorner(sourceCorner);
+        }
+    }
+
+    return true;
+}
+
+
+bool polyReorder::getEdgeOrder(
+    const std::vector<int> &edgeVertices,
+    const std::vector<int> &pointOrder,
+    const std::vector<int> &outEdgeVertices,
+    std::vector<int> &edgeOrder
+) {
+    int numberOfEdges = (int) edgeVertices.size() / 2;
+    uint64_t numberOfVertices = (uint64_t) pointOrder.size();
+
+    if ((int) outEdgeVertices.size() != numberOfEdges * 2)
+    {
+        return false;
+    }
+
+    auto edgeKey = [numberOfVertices](int v0, int v1)
+    {
+        return v0 < v1 ? v0 * numberOfVertices + v1 : v1 * numberOfVertices + v0;
+    };
+
+    std::vector<std::pair<uint64_t, int>> edges(numberOfEdges);
+    std::vector<std::pair<uint64_t, int>> outEdges(numberOfEdges);
+
+    for (int e = 0; e < numberOfEdges; e++)
+    {
+        edges[e] = std::make_pair(edgeKey(pointOrder[edgeVertices[e * 2]], pointOrder[edgeVertices[e * 2 + 1]]), e);
+        outEdges[e] = std::make_pair(edgeKey(outEdgeVertices[e * 2], outEdgeVertices[e * 2 + 1]), e);
+    }
+
+    std::sort(edges.begin(), edges.end());
+    std::sort(outEdges.begin(), outEdges.end());
+
+    edgeOrder.resize(numberOfEdges);
+
+    for (int i = 0; i < numberOfEdges; i++)
+    {
+        if (edges[i].first != outEdges[i].first)
+        {
+            edgeOrder.clear();
+            return false;
+        }
+
+        edgeOrder[edges[i].second] = outEdges[i].second;
+    }
+
+    return true;
+}
+
+
+void polyReorder::reorderFaceVertexIds(
+    const std::vector<int> &counts,
+    const std::vector<int> &ids,
+    const std::vector<int> &polyCounts,
+    const ComponentOrder &componentOrder,
+    std::vector<int> &outCounts,
+    std::vector<int> &outIds
+) {
+    const std::vector<int> &faceOrder = componentOrder.faceOrder;
+    const std::vector<int> &cornerOrder = componentOrder.cornerOrder;
+
+    int numberOfFaces = (int) faceOrder.size();
+
+    std::vector<int> cornerIds(cornerOrder.size(), -1);
+
+    outCounts.resize(numberOfFaces);
+
+    int corner = 0;
+    int id = 0;
+
+    for (int f = 0; f < numberOfFaces; f++)
+    {
+        int faceSize = polyCounts[faceOrder[f]];
+
+        if (counts[f] == faceSize)
+        {
+            for (int k = 0; k < faceSize; k++)
+            {
+                cornerIds[cornerOrder[corner + k]] = ids[id++];
+            }
+        } else {
+            id += counts[f];
+        }
+
+        outCounts[faceOrder[f]] = counts[f] == faceSize ? faceSize : 0;
+        corner += faceSize;
+    }
+
+    outIds.clear();
+    outIds.reserve(ids.size());
+
+    for (int cornerId : cornerIds)
+    {
+        if (cornerId != -1) { outIds.push_back(cornerId); }
+    }
+}
+
+
+bool polyReorder::hasMatchingOrder(
+    MeshTopology &sourceTopology,
+    std::vector<ComponentSelection> &sourceComponents,
+    MeshTopology &destinationTopology,
+    std::vector<ComponentSelection> &destinationComponents,
+    int numberOfThreads
+) {
+    LockstepWalk lockstepWalk(sourceTopology, destinationTopology, true);
+
+    bool walkSucceeded = lockstepWalk.walk(sourceComponents, destinationComponents, numberOfThreads);
+
+    return walkSucceeded && sourceTopology.isComplete() && destinationTopology.isComplete();
+}
+
+
+bool polyReorder::isIdentityOrder(const std::vector<int> &order)
+{
+    int numberOfIndices = (int) order.size();
+    const int *indices = order.data();
+
+    for (int first = 0; first < numberOfIndices; first += IDENTITY_BLOCK_SIZE)
+    {
+        int last = std::min(first + IDENTITY_BLOCK_SIZE, numberOfIndices);
+        int difference = 0;
+
+        for (int i = first; i < last; i++)
+        {
+            difference |= indices[i] ^ i;
+        }
+
+        if (difference != 0) { return false; }
+    }
+
+    return true;
+}
+
+
+bool polyReorder::isPermutation(const std::vector<int> &order, int numberOfIndices)
+{
+    if ((int) order.size() != numberOfIndices)
+    {
+        return false;
+    }
+
+    std::vector<char> seen(numberOfIndices, 0);
+
+    for (int index : order)
+    {
+        if (index < 0 || index >= numberOfIndices || seen[index]) { return false; }
+
+        seen[index] = 1;
+    }
+
+    return true;
+}
+
+
+bool polyReorder::isValidSelection(const MeshData &meshData, const ComponentSelection &selection)
+{
+    bool inRange = (
+           selection.faceIndex >= 0   && selection.faceIndex < meshData.numberOfFaces
+        && selection.edgeIndex >= 0   && selection.edgeIndex < meshData.numberOfEdges
+        && selection.vertexIndex >= 0 && selection.vertexIndex < meshData.numberOfVertices
+    );
+
+    if (!inRange) { return false; }
+
+    IndexRange faceEdges = meshData.faceEdges(selection.faceIndex);
+    IndexRange edgeVertices = meshData.edgeVertices(selection.edgeIndex);
+
+    bool edgeOnFace = std::find(faceEdges.begin(), faceEdges.end(), selection.edgeIndex) != faceEdges.end();
+    bool vertexOnEdge = std::find(edgeVertices.begin(), edgeVertices.end(), selection.vertexIndex) != edgeVertices.end();
+
+    return edgeOnFace && vertexOnEdge;
+}
+
+
+void polyReorder::reorderFloatPoints(
+    const float *points,
+    const std::vector<int> &pointOrder,
+    std::vector<float> &outPoints,
+    int numberOfThreads
+) {
+    int numberOfVertices = (int) pointOrder.size();
+    int numberOfChunks = (numberOfVertices + POINT_CHUNK_SIZE - 1) / POINT_CHUNK_SIZE;
+
+    outPoints.resize(numberOfVertices * 4);
+
+    float *out = outPoints.data();
+    const int *order = pointOrder.data();
+
+    polyReorder::parallelFor(numberOfChunks, numberOfThreads, [&](int chunk)
+    {
+        int first = chunk * POINT_CHUNK_SIZE;
+        int last = std::min(first + POINT_CHUNK_SIZE, numberOfVertices);
+
+        for (int i = first; i < last; i++)
+        {
+            const float *src = points + i * 3;
+            float *dst = out + order[i] * 4;
+
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = 1.0f;
+        }
+    });
+}
+
+
+void polyReorder::reorderPolys(const std::vector<int> &polyConnects, const std::vector<int> &pointOrder, std::vector<int> &outPolyConnects)
+{
+    outPolyConnects.resize(polyConnects.size());
+
+    for (size_t i = 0; i < polyConnects.size(); i++)
+    {
+        outPolyConnects[i] = pointOrder[polyConnects[i]];
+    }
+}
+
+
+void polyReorder::invertOrder(const std::vector<int> &order, std::vector<int> &inverseOrder)
+{
+    inverseOrder.resize(order.size());
+
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        inverseOrder[order[i]] = (int) i;
+    }
+}
+
+
+void polyReorder::invertComponentOrder(const ComponentOrder &componentOrder, ComponentOrder &inverseOrder)
+{
+    invertOrder(componentOrder.faceOrder, inverseOrder.faceOrder);
+    invertOrder(componentOrder.edgeOrder, inverseOrder.edgeOrder);
+    invertOrder(componentOrder.cornerOrder, inverseOrder.cornerOrder);
+}
+
+
+/**
+    Destination face f was rebuilt as face faceOrder[f], and each of its
+    corners c as corner cornerOrder[c], so both are read straight back.
+*/
+void polyReorder::restorePolys(
+    const std::vector<int> &polyCounts,
+    const std::vector<int> &polyConnects,
+    const std::vector<int> &inversePointOrder,
+    const ComponentOrder &componentOrder,
+    std::vector<int> &outPolyCounts,
+    std::vector<int> &outPolyConnects
+) {
+    const std::vector<int> &faceOrder = componentOrder.faceOrder;
+    const std::vector<int> &cornerOrder = componentOrder.cornerOrder;
+
+    outPolyCounts.resize(faceOrder.size());
+    outPolyConnects.resize(cornerOrder.size());
+
+    for (size_t f = 0; f < faceOrder.size(); f++)
+    {
+        outPolyCounts[f] = polyCounts[faceOrder[f]];
+    }
+
+    for (size_t c = 0; c < cornerOrder.size(); c++)
+    {
+        outPolyConnects[c] = inversePointOrder[polyConnects[cornerOrder[c]]];
+    }
+}
+
+
+void polyReorder::reorderEdgeVertices(
+    const std::vector<int> &edgeVertices,
+    const std::vector<int> &pointOrder,
+    const std::vector<int> &edgeOrder,
+    std::vector<int> &outEdgeVertices
+) {
+    int numberOfEdges = (int) edgeOrder.size();
+
+    outEdgeVertices.resize(edgeVertices.size());
+
+    for (int e = 0; e < numberOfEdges; e++)
+    {
+        outEdgeVertices[edgeOrder[e] * 2] = pointOrder[edgeVertices[e * 2]];
+        outEdgeVertices[edgeOrder[e] * 2 + 1] = pointOrder[edgeVertices[e * 2 + 1]];
+    }
+}
+
+
+bool polyReorder::hasSameEdges(const std::vector<int> &edgeVertices, const std::vector<int> &outEdgeVertices)
+{
+    if (edgeVertices.size() != outEdgeVertices.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i + 1 < edgeVertices.size(); i += 2)
+    {
+        int v0 = edgeVertices[i];
+        int v1 = edgeVertices[i + 1];
+
+        bool same = (
+               (outEdgeVertices[i] == v0 && outEdgeVertices[i + 1] == v1)
+            || (outEdgeVertices[i] == v1 && outEdgeVertices[i + 1] == v0)
+        );
+
+        if (!same) { return false; }
+    }
+
+    return true;
+}
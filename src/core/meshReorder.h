@@ -0,0 +1,251 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#ifndef YANTOR3D_MESH_REORDER_H
+#define YANTOR3D_MESH_REORDER_H
+
+#include "componentSelection.h"
+#include "lockstepWalk.h"
+#include "meshTopology.h"
+#include "progress.h"
+
+#include <vector>
+
+namespace polyReorder
+{
+    /**
+        Where the faces, edges and face corners of the destination land on the
+        source, in the same direction as pointOrder - faceOrder[destinationFace]
+        = sourceFace. Face corners are numbered in polyConnects order, which is
+        also the order of face-varying data such as UV and normal ids.
+    */
+    struct ComponentOrder
+    {
+        std::vector<int>    faceOrder;
+        std::vector<int>    edgeOrder;
+        std::vector<int>    cornerOrder;
+    };
+
+    /**
+        Walks both meshes together from their component selections and fills
+        pointOrder, where pointOrder[destinationVertex] = sourceVertex. Returns
+        false as soon as the two walks disagree - the place where they did is
+        written to mismatch if one is given - or if they do not reach every
+        vertex.
+
+        With numberOfThreads other than 1 independent shells are walked at the
+        same time (0 uses every hardware thread). The result does not depend on
+        the thread count. If progress is cancelled it returns false with no
+        mismatch.
+    */
+    bool getPointOrder(
+        MeshTopology &sourceTopology,
+        std::vector<ComponentSelection> &sourceComponents,
+        MeshTopology &destinationTopology,
+        std::vector<ComponentSelection> &destinationComponents,
+        std::vector<int> &pointOrder,
+        int numberOfThreads = 1,
+        WalkMismatch *mismatch = nullptr,
+        Progress *progress = nullptr
+    );
+
+    /**
+        Matches a destination against a source that has already been walked
+        from its own selections, walking only the destination. One walked
+        source can so be matched against many destinations, concurrently,
+        since the source is only read.
+
+        The two walks are independent, so nothing stops early; instead every
+        face and edge pair is checked through pointOrder once both are done.
+        Fills pointOrder and componentOrder and returns true only if they all
+        agree, and false if progress is cancelled during the walk. The
+        result is the same as getPointOrder followed by getComponentOrder.
+    */
+    bool getWalkedPointOrder(
+        MeshTopology &walkedSource,
+        MeshTopology &destinationTopology,
+        std::vector<ComponentSelection> &destinationComponents,
+        std::vector<int> &pointOrder,
+        ComponentOrder &componentOrder,
+        int numberOfThreads = 1,
+        Progress *progress = nullptr
+    );
+
+    /**
+        Reads the face, edge and face corner orders off the two walks that
+        filled pointOrder. Returns false if a component was not reached or a
+        face pair does not share its vertices.
+    */
+    bool getComponentOrder(
+        MeshTopology &sourceTopology,
+        MeshTopology &destinationTopology,
+        const std::vector<int> &pointOrder,
+        ComponentOrder &componentOrder
+    );
+
+    /**
+        Walks both meshes together, as getPointOrder does, but stops at the
+        first step that reaches a different vertex, edge or face index on the
+        two meshes. Returns true only if every step matched - that is, if the
+        meshes are already in the same order.
+    */
+    bool hasMatchingOrder(
+        MeshTopology &sourceTopology,
+        std::vector<ComponentSelection> &sourceComponents,
+        MeshTopology &destinationTopology,
+        std::vector<ComponentSelection> &destinationComponents,
+        int numberOfThreads = 1
+    );
+
+    /**
+        Returns true if order leaves every index where it is. Indices are
+        compared a block at a time without branching, so the compiler can
+        vectorise the inner loop.
+    */
+    bool isIdentityOrder(const std::vector<int> &order);
+
+    /**
+        Returns true if order holds numberOfIndices entries that visit every
+        index in [0, numberOfIndices) exactly once.
+    */
+    bool isPermutation(const std::vector<int> &order, int numberOfIndices);
+
+    /**
+        Returns true if the selection is in range of the mesh, its edge is on
+        its face and its vertex is on its edge - the only seeds a walk can
+        start from.
+    */
+    bool isValidSelection(const MeshData &meshData, const ComponentSelection &selection);
+
+    /**
+        Moves every value to its new index - values holds one tuple of the
+        given dimension per entry in order.
+    */
+    template <typename T>
+    void reorderValues(const std::vector<T> &values, const std::vector<int> &order, int dimension, std::vector<T> &outValues)
+    {
+        int numberOfValues = (int) order.size();
+
+        outValues.resize(values.size());
+
+        for (int i = 0; i < numberOfValues; i++)
+        {
+            const T *src = &values[i * dimension];
+            T *dst = &outValues[order[i] * dimension];
+
+            for (int d = 0; d < dimension; d++)
+            {
+                dst[d] = src[d];
+            }
+        }
+    }
+
+    /**
+        Reads one tuple of the given dimension from values for every id, so
+        that outValues[i] = values[ids[i]].
+    */
+    template <typename T>
+    void gatherValues(const std::vector<T> &values, const std::vector<int> &ids, int dimension, std::vector<T> &outValues)
+    {
+        int numberOfIds = (int) ids.size();
+
+        outValues.resize(numberOfIds * dimension);
+
+        for (int i = 0; i < numberOfIds; i++)
+        {
+            const T *src = &values[ids[i] * dimension];
+            T *dst = &outValues[i * dimension];
+
+            for (int d = 0; d < dimension; d++)
+            {
+                dst[d] = src[d];
+            }
+        }
+    }
+
+    /**
+        Moves packed xyz points to their new index as xyzw tuples with w = 1,
+        the layout MFloatPointArray is built from. Meshes with more than a
+        chunk of points are split across numberOfThreads (0 uses every
+        hardware thread).
+    */
+    void reorderFloatPoints(
+        const float *points,
+        const std::vector<int> &pointOrder,
+        std::vector<float> &outPoints,
+        int numberOfThreads = 0
+    );
+
+    /**
+        Matches the edges of a mesh to those of a copy whose points were moved
+        by pointOrder, by sorting both edge lists on their end points - for
+        when the copy was not built by a walk. Fills edgeOrder[edge] =
+        outEdge, and returns false if the copy has different edges.
+    */
+    bool getEdgeOrder(
+        const std::vector<int> &edgeVertices,
+        const std::vector<int> &pointOrder,
+        const std::vector<int> &outEdgeVertices,
+        std::vector<int> &edgeOrder
+    );
+
+    /**
+        Moves face-varying ids, such as assigned UVs, where counts holds how
+        many ids each destination face has - its size or 0. polyCounts holds
+        the size of each source face, and the results are in source order.
+    */
+    void reorderFaceVertexIds(
+        const std::vector<int> &counts,
+        const std::vector<int> &ids,
+        const std::vector<int> &polyCounts,
+        const ComponentOrder &componentOrder,
+        std::vector<int> &outCounts,
+        std::vector<int> &outIds
+    );
+
+    void reorderPolys(const std::vector<int> &polyConnects, const std::vector<int> &pointOrder, std::vector<int> &outPolyConnects);
+
+    /**
+        Fills inverseOrder so that inverseOrder[order[i]] = i - the order that
+        moves every index back to where it came from.
+    */
+    void invertOrder(const std::vector<int> &order, std::vector<int> &inverseOrder);
+
+    void invertComponentOrder(const ComponentOrder &componentOrder, ComponentOrder &inverseOrder);
+
+    /**
+        Recovers the faces a destination had before it was rebuilt with the
+        faces of its source, from the faces it has now and the orders that
+        rebuilt it. inversePointOrder is the inverse of that pointOrder.
+    */
+    void restorePolys(
+        const std::vector<int> &polyCounts,
+        const std::vector<int> &polyConnects,
+        const std::vector<int> &inversePointOrder,
+        const ComponentOrder &componentOrder,
+        std::vector<int> &outPolyCounts,
+        std::vector<int> &outPolyConnects
+    );
+
+    /**
+        Fills outEdgeVertices with the end points of the edges of the mesh
+        that pointOrder and edgeOrder take edgeVertices to, so that edge
+        edgeOrder[e] runs between pointOrder of the end points of edge e.
+    */
+    void reorderEdgeVertices(
+        const std::vector<int> &edgeVertices,
+        const std::vector<int> &pointOrder,
+        const std::vector<int> &edgeOrder,
+        std::vector<int> &outEdgeVertices
+    );
+
+    /**
+        Returns true if edge e runs between the same two vertices in both
+        lists, either way round, for every e.
+    */
+    bool hasSameEdges(const std::vector<int> &edgeVertices, const std::vector<int> &outEdgeVertices);
+}
+
+#endif
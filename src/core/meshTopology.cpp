@@ -0,0 +1,407 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "meshData.h"
+#include "meshTopology.h"
+#include "parallel.h"
+#include "progress.h"
+#include "topologyPath.h"
+
+#include <utility>
+#include <vector>
+#include <limits.h>
+
+
+MeshTopology::MeshTopology() {}
+
+
+MeshTopology::~MeshTopology() {}
+
+
+bool MeshTopology::setMesh(
+    int numVertices,
+    const std::vector<int> &polyCounts,
+    const std::vector<int> &polyConnects,
+    const std::vector<int> &edgeVertices,
+    Progress *progress
+) {
+    bool unpacked = meshData.unpackMesh(numVertices, polyCounts, polyConnects, edgeVertices, progress);
+
+    this->reset();
+
+    return unpacked;
+}
+
+
+void MeshTopology::reset()
+{
+    edgePath.resize(meshData.numberOfEdges);    
+    facePath.resize(meshData.numberOfFaces);
+    vertexPath.resize(meshData.numberOfVertices);
+
+    serialWalk = ShellWalk();
+    serialWalk.edges.queueCapacity = meshData.numberOfEdges;
+}
+
+
+bool MeshTopology::isComplete()
+{
+    int numVisited = serialWalk.vertices.numVisited;
+
+    return numVisited > 0 && numVisited == meshData.numberOfVertices;
+}
+
+
+/**
+    Bytes held by the unpacked mesh and the three paths.
+*/
+size_t MeshTopology::memoryUsage() const
+{
+    return (
+          meshData.memoryUsage()
+        + edgePath.memoryUsage()
+        + facePath.memoryUsage()
+        + vertexPath.memoryUsage()
+    );
+}
+
+
+bool MeshTopology::hasVisitedVertex(int i)
+{
+    return vertexPath.visited(i);
+}
+
+
+void MeshTopology::walk(polyReorder::ComponentSelection &startAt)
+{
+    walk(startAt, serialWalk, nullptr);
+
+    serialWalk.shellId++;
+}
+
+
+/**
+    Resets the topology and walks from every selection in order. With more than
+    one thread, selections are grouped by the vertex-connected piece of the
+    mesh they start on. Groups share no components, so each is walked on its
+    own thread into its own window of the paths. The windows are then stitched
+    back together in selection order, which gives exactly the result of
+    calling walk() once per selection.
+
+    If progress is cancelled the topology is reset, so it is left incomplete.
+*/
+void MeshTopology::walk(std::vector<polyReorder::ComponentSelection> &startAt, int numberOfThreads, Progress *progress)
+{
+    this->reset();
+
+    polyReorder::beginPhase(progress, "walkMesh", (size_t) meshData.numberOfEdges);
+
+    int numberOfShells = (int) startAt.size();
+
+    numberOfThreads = polyReorder::resolveThreadCount(numberOfThreads);
+
+    if (numberOfThreads == 1 || numberOfShells < 2)
+    {
+        for (polyReorder::ComponentSelection &cs : startAt)
+        {
+            if (!walk(cs, serialWalk, progress))
+            {
+                this->reset();
+                return;
+            }
+
+            serialWalk.shellId++;
+        }
+
+        return;
+    }
+
+    std::vector<int> pieces;
+    getPieces(startAt, pieces);
+
+    std::vector<int> pieceGroup(meshData.numberOfVertices, -1);
+    std::vector<int> shellGroup(numberOfShells);
+    std::vector<int> shellIndex(numberOfShells);
+
+    int numberOfGroups = 0;
+
+    for (int i = 0; i < numberOfShells; i++)
+    {
+        int piece = pieces[startAt[i].vertexIndex];
+
+        if (pieceGroup[piece] == -1)
+        {
+            pieceGroup[piece] = numberOfGroups++;
+        }
+
+        shellGroup[i] = pieceGroup[piece];
+        shellIndex[i] = i;
+    }
+
+    AdjacencyList groupShells;
+    groupShells.build(numberOfGroups, numberOfShells, shellGroup, shellIndex);
+
+    std::vector<ShellWalk> groupWalks(numberOfGroups);
+    getGroupWalks(pieces, pieceGroup, groupWalks);
+
+    ShellSegments segments(numberOfShells);
+
+    polyReorder::parallelFor(numberOfGroups, numberOfThreads, [&](int g)
+    {
+        for (int i : groupShells[g])
+        {
+            beginShell(i, groupWalks[g], segments);
+            bool walked = walk(startAt[i], groupWalks[g], progress);
+            endShell(i, groupWalks[g], segments);
+
+            if (!walked) { break; }
+        }
+    });
+
+    if (polyReorder::isCancelled(progress))
+    {
+        this->reset();
+        return;
+    }
+
+    collect(segments);
+}
+
+
+/**
+    Labels every vertex with the lowest vertex of its vertex-connected piece.
+    All three components of a selection are joined into one piece, so even a
+    malformed selection cannot let two pieces reach the same components.
+*/
+void MeshTopology::getPieces(std::vector<polyReorder::ComponentSelection> &startAt, std::vector<int> &pieces)
+{
+    int numberOfVertices = meshData.numberOfVertices;
+    int numberOfFaces = meshData.numberOfFaces;
+
+    pieces.resize(numberOfVertices);
+
+    for (int i = 0; i < numberOfVertices; i++)
+    {
+        pieces[i] = i;
+    }
+
+    auto find = [&pieces](int v)
+    {
+        while (pieces[v] != v)
+        {
+            pieces[v] = pieces[pieces[v]];
+            v = pieces[v];
+        }
+
+        return v;
+    };
+
+    auto unite = [&pieces, &find](int a, int b)
+    {
+        a = find(a);
+        b = find(b);
+
+        if (a < b) { pieces[b] = a; } else if (b < a) { pieces[a] = b; }
+    };
+
+    for (int f = 0; f < numberOfFaces; f++)
+    {
+        IndexRange faceVertices = meshData.faceVertices(f);
+
+        for (int v : faceVertices)
+        {
+            unite(faceVertices[0], v);
+        }
+    }
+
+    for (polyReorder::ComponentSelection &cs : startAt)
+    {
+        unite(cs.vertexIndex, meshData.edgeVertices(cs.edgeIndex)[0]);
+        unite(cs.vertexIndex, meshData.faceVertices(cs.faceIndex)[0]);
+    }
+
+    for (int v = 0; v < numberOfVertices; v++)
+    {
+        pieces[v] = find(v);
+    }
+}
+
+
+/**
+    Gives every group a window of each path, sized to the components of the
+    pieces that belong to it. pieceGroup maps a piece to its group, or -1 if
+    no selection starts on it.
+*/
+void MeshTopology::getGroupWalks(const std::vector<int> &pieces, const std::vector<int> &pieceGroup, std::vector<ShellWalk> &groupWalks)
+{
+    for (int v = 0; v < meshData.numberOfVertices; v++)
+    {
+        int g = pieceGroup[pieces[v]];
+        if (g != -1) { groupWalks[g].vertices.queueCapacity++; }
+    }
+
+    for (int e = 0; e < meshData.numberOfEdges; e++)
+    {
+        int g = pieceGroup[pieces[meshData.edgeVertices(e)[0]]];
+        if (g != -1) { groupWalks[g].edges.queueCapacity++; }
+    }
+
+    for (int f = 0; f < meshData.numberOfFaces; f++)
+    {
+        int g = pieceGroup[pieces[meshData.faceVertices(f)[0]]];
+        if (g != -1) { groupWalks[g].faces.queueCapacity++; }
+    }
+
+    int edgeBase = 0;
+    int faceBase = 0;
+    int vertexBase = 0;
+
+    for (ShellWalk &groupWalk : groupWalks)
+    {
+        groupWalk.edges.visitBase = groupWalk.edges.queueBase = edgeBase;
+        groupWalk.faces.visitBase = groupWalk.faces.queueBase = faceBase;
+        groupWalk.vertices.visitBase = groupWalk.vertices.queueBase = vertexBase;
+
+        edgeBase += groupWalk.edges.queueCapacity;
+        faceBase += groupWalk.faces.queueCapacity;
+        vertexBase += groupWalk.vertices.queueCapacity;
+    }
+}
+
+
+void MeshTopology::beginShell(int shell, ShellWalk &shellWalk, ShellSegments &segments)
+{
+    shellWalk.shellId = shell;
+
+    segments.edges[shell].first = shellWalk.edges.visitBase + shellWalk.edges.numVisited;
+    segments.faces[shell].first = shellWalk.faces.visitBase + shellWalk.faces.numVisited;
+    segments.vertices[shell].first = shellWalk.vertices.visitBase + shellWalk.vertices.numVisited;
+}
+
+
+void MeshTopology::endShell(int shell, ShellWalk &shellWalk, ShellSegments &segments)
+{
+    segments.edges[shell].second = shellWalk.edges.visitBase + shellWalk.edges.numVisited;
+    segments.faces[shell].second = shellWalk.faces.visitBase + shellWalk.faces.numVisited;
+    segments.vertices[shell].second = shellWalk.vertices.visitBase + shellWalk.vertices.numVisited;
+}
+
+
+void MeshTopology::collect(ShellSegments &segments)
+{
+    serialWalk.shellId = (int) segments.edges.size();
+    serialWalk.edges.numVisited = edgePath.collect(segments.edges);
+    serialWalk.faces.numVisited = facePath.collect(segments.faces);
+    serialWalk.vertices.numVisited = vertexPath.collect(segments.vertices);
+}
+
+
+void MeshTopology::walkStartingFace(polyReorder::ComponentSelection &startAt)
+{
+    walkStartingFace(startAt, serialWalk);
+}
+
+
+void MeshTopology::walkVerticesOnFace(int &faceIndex)
+{
+    walkVerticesOnFace(faceIndex, serialWalk);
+}
+
+
+/**
+    Returns false if progress was cancelled before the shell was done.
+*/
+bool MeshTopology::walk(polyReorder::ComponentSelection &startAt, ShellWalk &shellWalk, Progress *progress)
+{
+    walkStartingFace(startAt, shellWalk);
+
+    while (!edgePath.empty(shellWalk.edges))
+    {
+        if (!polyReorder::checkpoint(progress, shellWalk.steps++))
+        {
+            return false;
+        }
+
+        int nextEdge = edgePath.next(shellWalk.edges);
+
+        for (int faceIndex : meshData.edgeFaces(nextEdge))
+        {
+            if (!facePath.visited(faceIndex))
+            {
+                walkVerticesOnFace(faceIndex, shellWalk);
+            }
+        }
+    }
+
+    return true;
+}
+
+
+void MeshTopology::walkStartingFace(polyReorder::ComponentSelection &startAt, ShellWalk &shellWalk)
+{
+    vertexPath.visit(startAt.vertexIndex, shellWalk.shellId, shellWalk.vertices);
+    edgePath.visit(startAt.edgeIndex, shellWalk.shellId, shellWalk.edges);
+
+    if (!facePath.visited(startAt.faceIndex))
+    {
+        walkVerticesOnFace(startAt.faceIndex, shellWalk);
+    }
+}
+
+
+void MeshTopology::walkVerticesOnFace(int &faceIndex, ShellWalk &shellWalk)
+{
+    int firstEdge = getFirstVisited(meshData.faceEdges(faceIndex), edgePath);
+    int firstVertex = getFirstVisited(meshData.edgeVertices(firstEdge), vertexPath);
+
+    int corner = meshData.findCorner(faceIndex, firstEdge);
+    bool forward = meshData.cornerVertex(corner) == firstVertex;
+
+    int firstCorner = forward ? corner : meshData.nextCorner(corner);
+    
+    corner = firstCorner;
+
+    do
+    {
+        int nextEdge;
+
+        if (forward)
+        {
+            nextEdge = meshData.cornerEdge(corner);
+            corner = meshData.nextCorner(corner);
+        } else {
+            corner = meshData.prevCorner(corner);
+            nextEdge = meshData.cornerEdge(corner);
+        }
+
+        int nextVertex = meshData.cornerVertex(corner);
+
+        vertexPath.visit(nextVertex, shellWalk.shellId, shellWalk.vertices);
+        edgePath.visit(nextEdge, shellWalk.shellId, shellWalk.edges);
+        edgePath.push(nextEdge, shellWalk.edges);
+    } while (corner != firstCorner);
+
+    facePath.visit(faceIndex, shellWalk.shellId, shellWalk.faces);
+}
+
+
+int MeshTopology::getFirstVisited(const IndexRange &components, TopologyPath &path)
+{
+    int result = -1;
+    int visitOrder = INT_MAX;
+
+    for (int idx : components)
+    {
+        int vo = path.visitedAt(idx);
+
+        if (vo != -1 && vo < visitOrder) 
+        {   
+            result = idx;
+            visitOrder = vo;            
+        }
+    }
+
+    return result;
+}
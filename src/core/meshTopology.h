@@ -0,0 +1,113 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#ifndef YANTOR3D_MESH_TOPOLOGY_H
+#define YANTOR3D_MESH_TOPOLOGY_H
+
+#include "componentSelection.h"
+#include "meshData.h"
+#include "progress.h"
+#include "topologyPath.h"
+
+#include <utility>
+#include <vector>
+
+class MeshTopology
+{
+    friend class LockstepWalk;
+
+public:
+                MeshTopology();
+    virtual    ~MeshTopology();
+
+    int&        operator[] (int i) { return vertexPath[i]; }
+    int&        visitedEdge(int i) { return edgePath[i]; }
+    int&        visitedFace(int i) { return facePath[i]; }
+
+    bool        isComplete();
+    bool        hasVisitedVertex(int i);
+    
+    int         numberOfEdges() { return meshData.numberOfEdges; }
+    int         numberOfFaces() { return meshData.numberOfFaces; }
+    int         numberOfVertices() { return meshData.numberOfVertices; }
+
+    MeshData&   data() { return meshData; }
+
+    int         numberOfShells() { return serialWalk.shellId; }
+    int         numberOfVisitedEdges() { return serialWalk.edges.numVisited; }
+    int         numberOfVisitedFaces() { return serialWalk.faces.numVisited; }
+    int         numberOfVisitedVertices() { return serialWalk.vertices.numVisited; }
+
+    size_t      memoryUsage() const;
+
+    bool        setMesh(
+                    int numVertices,
+                    const std::vector<int> &polyCounts,
+                    const std::vector<int> &polyConnects,
+                    const std::vector<int> &edgeVertices,
+                    Progress *progress = nullptr
+                );
+    void        reset();
+
+    void        walk(polyReorder::ComponentSelection &startAt);
+    void        walk(std::vector<polyReorder::ComponentSelection> &startAt, int numberOfThreads, Progress *progress = nullptr);
+    void        walkStartingFace(polyReorder::ComponentSelection &startAt);
+    void        walkVerticesOnFace(int &faceIndex);
+
+private:
+    /**
+        Progress of one walk through the three paths. The serial walk uses the
+        member below; the threaded walk gives each group of shells its own.
+    */
+    struct ShellWalk
+    {
+        int             shellId = 0;
+        int             steps = 0;
+
+        PathCursor      edges;
+        PathCursor      faces;
+        PathCursor      vertices;
+    };
+
+    /**
+        Where each selection's visits landed in its group's window, so the
+        windows can be stitched back together in selection order.
+    */
+    struct ShellSegments
+    {
+                        ShellSegments(int numberOfShells) : 
+                            edges(numberOfShells), 
+                            faces(numberOfShells), 
+                            vertices(numberOfShells) 
+                        {}
+
+        std::vector<std::pair<int, int>>    edges;
+        std::vector<std::pair<int, int>>    faces;
+        std::vector<std::pair<int, int>>    vertices;
+    };
+
+    void        getPieces(std::vector<polyReorder::ComponentSelection> &startAt, std::vector<int> &pieces);
+    void        getGroupWalks(const std::vector<int> &pieces, const std::vector<int> &pieceGroup, std::vector<ShellWalk> &groupWalks);
+    void        beginShell(int shell, ShellWalk &shellWalk, ShellSegments &segments);
+    void        endShell(int shell, ShellWalk &shellWalk, ShellSegments &segments);
+    void        collect(ShellSegments &segments);
+
+    bool        walk(polyReorder::ComponentSelection &startAt, ShellWalk &shellWalk, Progress *progress);
+    void        walkStartingFace(polyReorder::ComponentSelection &startAt, ShellWalk &shellWalk);
+    void        walkVerticesOnFace(int &faceIndex, ShellWalk &shellWalk);
+
+    int         getFirstVisited(const IndexRange &components, TopologyPath &path);
+
+private:
+    MeshData            meshData;
+
+    ShellWalk           serialWalk;
+
+    TopologyPath        edgePath;
+    TopologyPath        facePath;
+    TopologyPath        vertexPath;
+};
+
+#endif
\ No newline at end of file
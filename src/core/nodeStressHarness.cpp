@@ -0,0 +1,250 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+/**
+    Evaluates many simulated polyReorder nodes at once, the way the
+    evaluation manager does under parallel scheduling, without a scene. Each
+    node keeps its own locked cache, checks and hashes its inputs, rebuilds
+    when its key changes and otherwise only moves the points, just as the
+    node does. Every output is checked against a plain serial reorder, and
+    the exit code is non-zero if any of them differ.
+
+    Usage: polyReorderNodeStress [nodes] [frames] [gridSize] [workers] [threadsPerNode]
+*/
+
+#include "meshReorder.h"
+#include "parallel.h"
+#include "topologyFingerprint.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <vector>
+
+
+namespace
+{
+    /**
+        A grid of size x size quads.
+    */
+    struct GridMesh
+    {
+        int                 numVertices = 0;
+
+        std::vector<int>    polyCounts;
+        std::vector<int>    polyConnects;
+        std::vector<float>  points;
+    };
+
+    void getGridMesh(int size, GridMesh &mesh)
+    {
+        int rowLength = size + 1;
+
+        mesh.numVertices = rowLength * rowLength;
+        mesh.polyCounts.assign(size * size, 4);
+        mesh.polyConnects.clear();
+        mesh.points.clear();
+
+        for (int y = 0; y < size; y++)
+        {
+            for (int x = 0; x < size; x++)
+            {
+                int corner = y * rowLength + x;
+
+                mesh.polyConnects.push_back(corner);
+                mesh.polyConnects.push_back(corner + 1);
+                mesh.polyConnects.push_back(corner + rowLength + 1);
+                mesh.polyConnects.push_back(corner + rowLength);
+            }
+        }
+
+        for (int y = 0; y < rowLength; y++)
+        {
+            for (int x = 0; x < rowLength; x++)
+            {
+                mesh.points.push_back((float) x);
+                mesh.points.push_back(0.0f);
+                mesh.points.push_back((float) y);
+            }
+        }
+    }
+
+    /**
+        What a node would be handed on one frame: the points its input is
+        deformed to, and the order connected to it.
+    */
+    struct Frame
+    {
+        std::vector<float>          points;
+        const std::vector<int>      *order      = nullptr;
+        uint64_t                    orderKey    = 0;
+    };
+
+    /**
+        The state a polyReorder node keeps between evaluations, and what
+        compute does with it.
+    */
+    class SimulatedNode
+    {
+    public:
+        bool                evaluate(const GridMesh &mesh, const Frame &frame, int numberOfThreads, std::vector<float> &outPoints);
+
+        int                 numberOfRebuilds() const { return rebuilds; }
+        int                 numberOfUpdates() const { return updates; }
+
+    private:
+        std::mutex          cacheMutex;
+
+        bool                hasCache            = false;
+        uint64_t            cachedTopology      = 0;
+        uint64_t            cachedPointOrder    = 0;
+        std::vector<int>    cachedConnects;
+
+        int                 rebuilds            = 0;
+        int                 updates             = 0;
+    };
+
+    bool SimulatedNode::evaluate(const GridMesh &mesh, const Frame &frame, int numberOfThreads, std::vector<float> &outPoints)
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+
+        const std::vector<int> &order = *frame.order;
+
+        if (!polyReorder::isPermutation(order, mesh.numVertices)) { return false; }
+
+        uint64_t topology = polyReorder::hashValues(mesh.polyCounts.data(), mesh.polyCounts.size(), 0, numberOfThreads);
+        topology = polyReorder::hashValues(mesh.polyConnects.data(), mesh.polyConnects.size(), topology, numberOfThreads);
+
+        if (!hasCache || topology != cachedTopology || frame.orderKey != cachedPointOrder)
+        {
+            polyReorder::reorderPolys(mesh.polyConnects, order, cachedConnects);
+
+            hasCache = true;
+            cachedTopology = topology;
+            cachedPointOrder = frame.orderKey;
+
+            rebuilds++;
+        } else {
+            updates++;
+        }
+
+        polyReorder::reorderFloatPoints(frame.points.data(), order, outPoints, numberOfThreads);
+
+        return true;
+    }
+
+    /**
+        Returns true if outPoints holds points moved by order, written out
+        one point at a time.
+    */
+    bool isReordered(const std::vector<float> &points, const std::vector<int> &order, const std::vector<float> &outPoints)
+    {
+        if (outPoints.size() != order.size() * 4) { return false; }
+
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            const float *src = points.data() + i * 3;
+            const float *dst = outPoints.data() + order[i] * 4;
+
+            if (dst[0] != src[0] || dst[1] != src[1] || dst[2] != src[2] || dst[3] != 1.0f)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    int getArgument(int argc, char **argv, int index, int defaultValue)
+    {
+        return argc > index ? std::max(std::atoi(argv[index]), 1) : defaultValue;
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+    int numberOfNodes = getArgument(argc, argv, 1, 16);
+    int numberOfFrames = getArgument(argc, argv, 2, 20);
+    int gridSize = getArgument(argc, argv, 3, 300);
+    int numberOfWorkers = getArgument(argc, argv, 4, 4);
+    int threadsPerNode = getArgument(argc, argv, 5, 1);
+
+    GridMesh mesh;
+    getGridMesh(gridSize, mesh);
+
+    std::mt19937 rng(1);
+
+    std::vector<std::vector<int>> orders(2, std::vector<int>(mesh.numVertices));
+    std::vector<uint64_t> orderKeys(orders.size());
+
+    for (size_t o = 0; o < orders.size(); o++)
+    {
+        for (int i = 0; i < mesh.numVertices; i++)
+        {
+            orders[o][i] = i;
+        }
+
+        std::shuffle(orders[o].begin(), orders[o].end(), rng);
+        orderKeys[o] = polyReorder::hashValues(orders[o].data(), orders[o].size());
+    }
+
+    std::vector<SimulatedNode> nodes(numberOfNodes);
+    std::atomic<int> failures(0);
+
+    polyReorder::parallelFor(numberOfNodes * numberOfFrames, numberOfWorkers, [&](int job)
+    {
+        int node = job % numberOfNodes;
+        int frameNumber = job / numberOfNodes;
+
+        Frame frame;
+        frame.points = mesh.points;
+        frame.order = &orders[(frameNumber / 5 + node) % orders.size()];
+        frame.orderKey = orderKeys[(frameNumber / 5 + node) % orders.size()];
+
+        for (size_t i = 1; i < frame.points.size(); i += 3)
+        {
+            frame.points[i] = (float) (node * 1000 + frameNumber);
+        }
+
+        std::vector<float> outPoints;
+
+        bool succeeded = (
+               nodes[node].evaluate(mesh, frame, threadsPerNode, outPoints)
+            && isReordered(frame.points, *frame.order, outPoints)
+        );
+
+        if (!succeeded)
+        {
+            failures++;
+        }
+    });
+
+    int rebuilds = 0;
+    int updates = 0;
+
+    for (SimulatedNode &node : nodes)
+    {
+        rebuilds += node.numberOfRebuilds();
+        updates += node.numberOfUpdates();
+    }
+
+    printf(
+        "%d nodes x %d frames of a %d vertex grid on %d workers: %d rebuilds, %d updates, %d failures\n",
+        numberOfNodes,
+        numberOfFrames,
+        mesh.numVertices,
+        numberOfWorkers,
+        rebuilds,
+        updates,
+        failures.load()
+    );
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,19 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "parallel.h"
+
+#include <thread>
+
+
+int polyReorder::resolveThreadCount(int numberOfThreads)
+{
+    if (numberOfThreads <= 0)
+    {
+        numberOfThreads = (int) std::thread::hardware_concurrency();
+    }
+
+    return std::max(numberOfThreads, 1);
+}
@@ -0,0 +1,69 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#ifndef YANTOR3D_PARALLEL_H
+#define YANTOR3D_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace polyReorder
+{
+    /**
+        Returns numberOfThreads, or the number of hardware threads if it is
+        zero or less.
+    */
+    int resolveThreadCount(int numberOfThreads);
+
+    /**
+        Calls function(i) for every i in [0, count) on up to numberOfThreads
+        threads. Indices are handed out one at a time, so uneven tasks still
+        balance. Runs inline when there is only one thread or one task.
+    */
+    template <typename Function>
+    void parallelFor(int count, int numberOfThreads, Function function)
+    {
+        numberOfThreads = std::min(resolveThreadCount(numberOfThreads), count);
+
+        if (numberOfThreads <= 1)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                function(i);
+            }
+
+            return;
+        }
+
+        std::atomic<int> nextIndex(0);
+
+        auto worker = [&]()
+        {
+            for (int i = nextIndex++; i < count; i = nextIndex++)
+            {
+                function(i);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads - 1);
+
+        for (int i = 1; i < numberOfThreads; i++)
+        {
+            threads.emplace_back(worker);
+        }
+
+        worker();
+
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+    }
+}
+
+#endif
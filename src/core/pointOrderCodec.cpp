@@ -0,0 +1,181 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "pointOrderCodec.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <limits.h>
+
+
+namespace
+{
+    const char POINT_ORDER_FILE_MAGIC[4] = { 'P', 'R', 'P', 'O' };
+    const int  POINT_ORDER_FILE_VERSION = 1;
+}
+
+
+void polyReorder::encodePointOrder(const std::vector<int> &pointOrder, std::vector<int> &codes)
+{
+    codes.clear();
+
+    int numberOfIndices = (int) pointOrder.size();
+
+    int i = 0;
+
+    while (i < numberOfIndices)
+    {
+        int first = pointOrder[i];
+        int length = 1;
+
+        while (i + length < numberOfIndices && pointOrder[i + length] == first + length)
+        {
+            length++;
+        }
+
+        codes.push_back(first);
+
+        if (length > 1)
+        {
+            codes.push_back(-length);
+        }
+
+        i += length;
+    }
+}
+
+
+/**
+    A negative code is only valid straight after an index, and an index must
+    not be negative or let its run pass INT_MAX.
+*/
+int polyReorder::decodedLength(const int *codes, int numberOfCodes)
+{
+    long long result = 0;
+
+    int c = 0;
+
+    while (c < numberOfCodes)
+    {
+        int first = codes[c++];
+        int length = 1;
+
+        if (first < 0) { return -1; }
+
+        if (c < numberOfCodes && codes[c] < 0)
+        {
+            if (codes[c] == INT_MIN || codes[c] == -1) { return -1; }
+
+            length = -codes[c++];
+        }
+
+        if (length - 1 > INT_MAX - first) { return -1; }
+
+        result += length;
+    }
+
+    return result > INT_MAX ? -1 : (int) result;
+}
+
+
+void polyReorder::decodePointOrder(const int *codes, int numberOfCodes, int *pointOrder)
+{
+    int c = 0;
+
+    while (c < numberOfCodes)
+    {
+        int first = codes[c++];
+        int length = 1;
+
+        if (c < numberOfCodes && codes[c] < 0)
+        {
+            length = -codes[c++];
+        }
+
+        for (int i = 0; i < length; i++)
+        {
+            pointOrder[i] = first + i;
+        }
+
+        pointOrder += length;
+    }
+}
+
+
+/**
+    The header is the magic, the version, the number of indices and the
+    number of codes, followed by the codes.
+*/
+bool polyReorder::writePointOrderFile(const char *path, const std::vector<int> &pointOrder)
+{
+    std::vector<int> codes;
+    encodePointOrder(pointOrder, codes);
+
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!out) { return false; }
+
+    int header[3] = { 
+        POINT_ORDER_FILE_VERSION, 
+        (int) pointOrder.size(), 
+        (int) codes.size() 
+    };
+
+    out.write(POINT_ORDER_FILE_MAGIC, sizeof(POINT_ORDER_FILE_MAGIC));
+    out.write((const char*) header, sizeof(header));
+    out.write((const char*) codes.data(), codes.size() * sizeof(int));
+
+    out.close();
+
+    return !out.fail();
+}
+
+
+/**
+    A run of two or more indices takes two codes, so a valid file never has
+    more codes than indices. That bounds what a damaged header can allocate.
+*/
+bool polyReorder::readPointOrderFile(const char *path, std::vector<int> &pointOrder)
+{
+    pointOrder.clear();
+
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+
+    if (!in) { return false; }
+
+    char magic[4];
+    int header[3];
+
+    in.read(magic, sizeof(magic));
+    in.read((char*) header, sizeof(header));
+
+    if (!in || std::memcmp(magic, POINT_ORDER_FILE_MAGIC, sizeof(magic)) != 0)
+    {
+        return false;
+    }
+
+    int version = header[0];
+    int numberOfIndices = header[1];
+    int numberOfCodes = header[2];
+
+    if (version != POINT_ORDER_FILE_VERSION || numberOfIndices < 0 || numberOfCodes < 0 || numberOfCodes > numberOfIndices)
+    {
+        return false;
+    }
+
+    std::vector<int> codes(numberOfCodes);
+    in.read((char*) codes.data(), codes.size() * sizeof(int));
+
+    if (!in || decodedLength(codes.data(), numberOfCodes) != numberOfIndices)
+    {
+        return false;
+    }
+
+    pointOrder.resize(numberOfIndices);
+    decodePointOrder(codes.data(), numberOfCodes, pointOrder.data());
+
+    return true;
+}
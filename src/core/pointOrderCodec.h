@@ -0,0 +1,49 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#ifndef YANTOR3D_POINT_ORDER_CODEC_H
+#define YANTOR3D_POINT_ORDER_CODEC_H
+
+#include <vector>
+
+namespace polyReorder
+{
+    /**
+        Encodes pointOrder as runs of consecutive ascending indices. Each run
+        is written as its first index, followed by minus its length if that is
+        more than one. Reorders mostly move whole shells or strips of points at
+        a time, so a few runs usually cover millions of points, and an order
+        with no runs at all is no larger than it was.
+    */
+    void encodePointOrder(const std::vector<int> &pointOrder, std::vector<int> &codes);
+
+    /**
+        Counts the indices the codes expand to, or returns -1 if they are not
+        a valid encoding.
+    */
+    int  decodedLength(const int *codes, int numberOfCodes);
+
+    /**
+        Expands numberOfCodes codes into pointOrder, which must already hold
+        decodedLength(codes, numberOfCodes) entries.
+    */
+    void decodePointOrder(const int *codes, int numberOfCodes, int *pointOrder);
+
+    /**
+        Writes pointOrder to a file as its codes, behind a short header that
+        holds the number of indices. The file is in native byte order.
+        Returns false if the file could not be written.
+    */
+    bool writePointOrderFile(const char *path, const std::vector<int> &pointOrder);
+
+    /**
+        Reads a file written by writePointOrderFile into pointOrder. Returns
+        false, and leaves pointOrder empty, if the file cannot be read or
+        does not decode to the length in its header.
+    */
+    bool readPointOrderFile(const char *path, std::vector<int> &pointOrder);
+}
+
+#endif
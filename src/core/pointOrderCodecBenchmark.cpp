@@ -0,0 +1,161 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+/**
+    Times how long point orders take to encode, decode, save and load with
+    the codec the polyReorder node stores them in. Needs no Maya, so it is
+    built with polyReorderCore.
+
+    Usage: polyReorderCodecBenchmark [numberOfPoints] [scratchFile]
+*/
+
+#include "pointOrderCodec.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    double millisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    /**
+        An order that moves whole shells of 1000 to 21000 points at a time,
+        as reordering a mesh of many separate pieces does.
+    */
+    void getShellOrder(int numberOfPoints, std::mt19937 &rng, std::vector<int> &pointOrder)
+    {
+        std::vector<int> shellStarts;
+        std::vector<int> shellSizes;
+
+        for (int start = 0; start < numberOfPoints; )
+        {
+            int size = std::min(numberOfPoints - start, 1000 + (int) (rng() % 20000));
+
+            shellStarts.push_back(start);
+            shellSizes.push_back(size);
+
+            start += size;
+        }
+
+        std::vector<int> shells(shellStarts.size());
+
+        for (size_t s = 0; s < shells.size(); s++)
+        {
+            shells[s] = (int) s;
+        }
+
+        std::shuffle(shells.begin(), shells.end(), rng);
+
+        pointOrder.clear();
+        pointOrder.reserve(numberOfPoints);
+
+        for (int s : shells)
+        {
+            for (int i = 0; i < shellSizes[s]; i++)
+            {
+                pointOrder.push_back(shellStarts[s] + i);
+            }
+        }
+    }
+
+    /**
+        Runs every step on pointOrder once and prints a line of timings.
+        Returns false if anything failed or did not come back unchanged.
+    */
+    bool benchmark(const char *name, const std::vector<int> &pointOrder, const char *path)
+    {
+        std::vector<int> codes;
+        std::vector<int> decoded;
+        std::vector<int> loaded;
+
+        Clock::time_point start = Clock::now();
+        polyReorder::encodePointOrder(pointOrder, codes);
+        double encodeTime = millisecondsSince(start);
+
+        start = Clock::now();
+
+        int numberOfCodes = (int) codes.size();
+        int numberOfIndices = polyReorder::decodedLength(codes.data(), numberOfCodes);
+
+        if (numberOfIndices == -1) { return false; }
+
+        decoded.resize(numberOfIndices);
+        polyReorder::decodePointOrder(codes.data(), numberOfCodes, decoded.data());
+
+        double decodeTime = millisecondsSince(start);
+
+        start = Clock::now();
+        bool saved = polyReorder::writePointOrderFile(path, pointOrder);
+        double saveTime = millisecondsSince(start);
+
+        start = Clock::now();
+        bool loadedOk = saved && polyReorder::readPointOrderFile(path, loaded);
+        double loadTime = millisecondsSince(start);
+
+        std::remove(path);
+
+        bool matches = loadedOk && decoded == pointOrder && loaded == pointOrder;
+
+        printf(
+            "%-8s %10zu points %10zu codes   encode %8.2f ms   decode %8.2f ms   save %8.2f ms   load %8.2f ms   %s\n",
+            name,
+            pointOrder.size(),
+            codes.size(),
+            encodeTime,
+            decodeTime,
+            saveTime,
+            loadTime,
+            matches ? "ok" : "FAILED"
+        );
+
+        return matches;
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+    int numberOfPoints = argc > 1 ? std::atoi(argv[1]) : 4000000;
+    const char *path = argc > 2 ? argv[2] : "pointOrderCodecBenchmark.tmp";
+
+    if (numberOfPoints < 0)
+    {
+        fprintf(stderr, "numberOfPoints must not be negative.\n");
+        return 2;
+    }
+
+    std::mt19937 rng(3);
+
+    std::vector<int> identityOrder(numberOfPoints);
+
+    for (int i = 0; i < numberOfPoints; i++)
+    {
+        identityOrder[i] = i;
+    }
+
+    std::vector<int> shellOrder;
+    getShellOrder(numberOfPoints, rng, shellOrder);
+
+    std::vector<int> randomOrder(identityOrder);
+    std::shuffle(randomOrder.begin(), randomOrder.end(), rng);
+
+    bool succeeded = true;
+
+    succeeded = benchmark("identity", identityOrder, path) && succeeded;
+    succeeded = benchmark("shells", shellOrder, path) && succeeded;
+    succeeded = benchmark("random", randomOrder, path) && succeeded;
+
+    return succeeded ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "progress.h"
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+
+Progress::Progress(ProgressMonitor *monitor) :
+    monitor(monitor),
+    owner(std::this_thread::get_id()),
+    stepsDone(0),
+    cancelled(false)
+{}
+
+
+/**
+    Does nothing off the owning thread, so code that may run on a worker can
+    still begin its phases.
+*/
+void Progress::beginPhase(const char *phase, size_t numberOfSteps)
+{
+    if (std::this_thread::get_id() != owner)
+    {
+        return;
+    }
+
+    this->numberOfSteps = numberOfSteps;
+    this->stepsDone.store(0, std::memory_order_relaxed);
+
+    if (monitor)
+    {
+        monitor->beginPhase(phase, numberOfSteps);
+    }
+}
+
+
+bool Progress::advance(size_t steps)
+{
+    size_t done = stepsDone.fetch_add(steps, std::memory_order_relaxed) + steps;
+
+    if (monitor && !isCancelled() && std::this_thread::get_id() == owner)
+    {
+        if (!monitor->update(done, numberOfSteps))
+        {
+            cancelled.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    return !isCancelled();
+}
+
+
+void polyReorder::beginPhase(Progress *progress, const char *phase, size_t numberOfSteps)
+{
+    if (progress)
+    {
+        progress->beginPhase(phase, numberOfSteps);
+    }
+}
@@ -0,0 +1,105 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#ifndef YANTOR3D_PROGRESS_H
+#define YANTOR3D_PROGRESS_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace polyReorder
+{
+    /**
+        Steps between two looks at the monitor. Loops only test their step
+        count against it, so a checkpoint costs a mask and a branch.
+    */
+    const int PROGRESS_INTERVAL = 1 << 16;
+}
+
+
+/**
+    Told how far a long operation has got, by the thread that started it
+    only. Returning false from update() asks the operation to stop.
+*/
+class ProgressMonitor
+{
+public:
+    virtual             ~ProgressMonitor() {}
+
+    virtual void        beginPhase(const char *phase, size_t numberOfSteps) = 0;
+    virtual bool        update(size_t stepsDone, size_t numberOfSteps) = 0;
+};
+
+
+/**
+    Counts the steps of the current phase and passes them on to a monitor.
+    Loops on any thread may add steps; only the thread that made the
+    Progress talks to the monitor, so it never has to be thread safe. Once
+    cancelled, a Progress stays cancelled.
+*/
+class Progress
+{
+public:
+                        Progress(ProgressMonitor *monitor=nullptr);
+
+    void                beginPhase(const char *phase, size_t numberOfSteps);
+    bool                advance(size_t steps);
+
+    bool                isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+private:
+    ProgressMonitor     *monitor;
+    std::thread::id     owner;
+
+    size_t              numberOfSteps = 0;
+
+    std::atomic<size_t> stepsDone;
+    std::atomic<bool>   cancelled;
+};
+
+
+namespace polyReorder
+{
+    /**
+        Starts a phase of numberOfSteps steps, if there is a progress.
+    */
+    void beginPhase(Progress *progress, const char *phase, size_t numberOfSteps);
+
+    /**
+        Called with a step count that goes up by one each time round a loop.
+        Returns false if the operation has been cancelled, but only looks on
+        the last step of every PROGRESS_INTERVAL, so it returns true at once
+        almost every time.
+    */
+    inline bool checkpoint(Progress *progress, int step)
+    {
+        return (
+               (step & (PROGRESS_INTERVAL - 1)) != PROGRESS_INTERVAL - 1
+            || progress == nullptr
+            || progress->advance(PROGRESS_INTERVAL)
+        );
+    }
+
+    /**
+        Adds steps to the current phase and looks at the monitor at once, for
+        steps too coarse to go through checkpoint(). Returns false if the
+        operation has been cancelled.
+    */
+    inline bool advance(Progress *progress, size_t steps)
+    {
+        return progress == nullptr || progress->advance(steps);
+    }
+
+    /**
+        Returns true if there is a progress and it has been cancelled.
+    */
+    inline bool isCancelled(Progress *progress)
+    {
+        return progress != nullptr && progress->isCancelled();
+    }
+}
+
+#endif
@@ -0,0 +1,260 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "meshData.h"
+#include "parallel.h"
+#include "topologyFingerprint.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+namespace
+{
+    const int FINGERPRINT_CHUNK_SIZE = 1 << 16;
+
+    /**
+        splitmix64 finaliser - a cheap, well distributed 64 bit mix.
+    */
+    inline uint64_t mix(uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    /**
+        Hash of an unordered pair of colours, so a face reads the same in
+        either winding. Colours are already mixed, so one more round will do.
+    */
+    inline uint64_t mixPair(uint64_t a, uint64_t b)
+    {
+        return mix((std::min(a, b) * 0xff51afd7ed558ccdULL) ^ std::max(a, b));
+    }
+
+    /**
+        Calls function(first, last) over [0, count) in fixed size chunks and
+        returns the sum of the chunk results. Addition is commutative, so the
+        total does not depend on which thread ran which chunk.
+    */
+    template <typename Function>
+    uint64_t parallelSum(int count, int numberOfThreads, Function function)
+    {
+        int numberOfChunks = (count + FINGERPRINT_CHUNK_SIZE - 1) / FINGERPRINT_CHUNK_SIZE;
+
+        std::vector<uint64_t> chunkSums(numberOfChunks, 0);
+
+        polyReorder::parallelFor(numberOfChunks, numberOfThreads, [&](int chunk)
+        {
+            int first = chunk * FINGERPRINT_CHUNK_SIZE;
+            int last = std::min(first + FINGERPRINT_CHUNK_SIZE, count);
+
+            chunkSums[chunk] = function(first, last);
+        });
+
+        uint64_t result = 0;
+
+        for (uint64_t chunkSum : chunkSums)
+        {
+            result += chunkSum;
+        }
+
+        return result;
+    }
+}
+
+
+uint64_t polyReorder::TopologyFingerprint::hash() const
+{
+    uint64_t result = mix(uint64_t(numberOfVertices));
+
+    result = mix(result ^ uint64_t(numberOfEdges));
+    result = mix(result ^ uint64_t(numberOfFaces));
+    result = mix(result ^ uint64_t(numberOfCorners));
+    result = mix(result ^ valenceHash);
+    result = mix(result ^ refinedHash);
+
+    return result;
+}
+
+
+bool polyReorder::TopologyFingerprint::operator== (const TopologyFingerprint &other) const
+{
+    return (
+           numberOfVertices == other.numberOfVertices
+        && numberOfEdges    == other.numberOfEdges
+        && numberOfFaces    == other.numberOfFaces
+        && numberOfCorners  == other.numberOfCorners
+        && valenceHash      == other.valenceHash
+        && refinedHash      == other.refinedHash
+    );
+}
+
+
+polyReorder::TopologyFingerprint polyReorder::getTopologyFingerprint(
+    int numVertices,
+    int numEdges,
+    const std::vector<int> &polyCounts,
+    const std::vector<int> &polyConnects,
+    int rounds,
+    int numberOfThreads
+) {
+    TopologyFingerprint result;
+
+    int numFaces = (int) polyCounts.size();
+    int numCorners = (int) polyConnects.size();
+
+    result.numberOfVertices = numVertices;
+    result.numberOfEdges = numEdges;
+    result.numberOfFaces = numFaces;
+    result.numberOfCorners = numCorners;
+
+    std::vector<int> faceOffsets(numFaces + 1, 0);
+    std::vector<int> cornerFaces(numCorners);
+
+    for (int f = 0; f < numFaces; f++)
+    {
+        faceOffsets[f + 1] = faceOffsets[f] + polyCounts[f];
+
+        std::fill(cornerFaces.begin() + faceOffsets[f], cornerFaces.begin() + faceOffsets[f + 1], f);
+    }
+
+    AdjacencyList vertexFaces;
+    vertexFaces.build(numVertices, numFaces, polyConnects, cornerFaces);
+
+    std::vector<uint64_t> faceColors(numFaces);
+    std::vector<uint64_t> vertexColors(numVertices);
+
+    uint64_t faceHistogram = parallelSum(numFaces, numberOfThreads, [&](int first, int last)
+    {
+        uint64_t sum = 0;
+
+        for (int f = first; f < last; f++)
+        {
+            faceColors[f] = mix(uint64_t(polyCounts[f]));
+            sum += faceColors[f];
+        }
+
+        return sum;
+    });
+
+    uint64_t vertexHistogram = parallelSum(numVertices, numberOfThreads, [&](int first, int last)
+    {
+        uint64_t sum = 0;
+
+        for (int v = first; v < last; v++)
+        {
+            vertexColors[v] = mix(uint64_t(vertexFaces[v].size()) ^ 0x5bd1e995ULL);
+            sum += vertexColors[v];
+        }
+
+        return sum;
+    });
+
+    result.valenceHash = mix(faceHistogram) ^ vertexHistogram;
+
+    std::vector<uint64_t> nextFaceColors(numFaces);
+    std::vector<uint64_t> nextVertexColors(numVertices);
+
+    uint64_t faceSum = faceHistogram;
+    uint64_t vertexSum = vertexHistogram;
+
+    for (int round = 0; round < rounds; round++)
+    {
+        faceSum = parallelSum(numFaces, numberOfThreads, [&](int first, int last)
+        {
+            uint64_t sum = 0;
+
+            for (int f = first; f < last; f++)
+            {
+                int firstCorner = faceOffsets[f];
+                int faceSize = polyCounts[f];
+
+                uint64_t neighbours = 0;
+                uint64_t a = vertexColors[polyConnects[firstCorner + faceSize - 1]];
+
+                for (int i = 0; i < faceSize; i++)
+                {
+                    uint64_t b = vertexColors[polyConnects[firstCorner + i]];
+
+                    neighbours += b + mixPair(a, b);
+                    a = b;
+                }
+
+                nextFaceColors[f] = mix(faceColors[f] ^ neighbours);
+                sum += nextFaceColors[f];
+            }
+
+            return sum;
+        });
+
+        vertexSum = parallelSum(numVertices, numberOfThreads, [&](int first, int last)
+        {
+            uint64_t sum = 0;
+
+            for (int v = first; v < last; v++)
+            {
+                uint64_t neighbours = 0;
+
+                for (int f : vertexFaces[v])
+                {
+                    neighbours += nextFaceColors[f];
+                }
+
+                nextVertexColors[v] = mix(vertexColors[v] ^ neighbours);
+                sum += nextVertexColors[v];
+            }
+
+            return sum;
+        });
+
+        faceColors.swap(nextFaceColors);
+        vertexColors.swap(nextVertexColors);
+    }
+
+    result.refinedHash = mix(faceSum) ^ vertexSum;
+
+    return result;
+}
+
+
+/**
+    Hashes each chunk on its own, seeded with where it starts, so the sum of
+    the chunks still depends on the order of the values.
+*/
+uint64_t polyReorder::hashValues(const void *values, size_t numberOfValues, uint64_t seed, int numberOfThreads)
+{
+    const unsigned char *bytes = (const unsigned char *) values;
+
+    uint64_t chunkSum = parallelSum((int) numberOfValues, numberOfThreads, [bytes](int first, int last)
+    {
+        uint64_t result = mix(uint64_t(first));
+
+        int i = first;
+
+        for (; i + 1 < last; i += 2)
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes + size_t(i) * 4, 8);
+
+            result = mix(result ^ word);
+        }
+
+        if (i < last)
+        {
+            uint32_t value;
+            std::memcpy(&value, bytes + size_t(i) * 4, 4);
+
+            result = mix(result ^ value);
+        }
+
+        return result;
+    });
+
+    return mix(mix(seed ^ numberOfValues) ^ chunkSum);
+}
@@ -0,0 +1,62 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#ifndef YANTOR3D_TOPOLOGY_FINGERPRINT_H
+#define YANTOR3D_TOPOLOGY_FINGERPRINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace polyReorder
+{
+    /**
+        Summary of a mesh's connectivity that does not depend on how its
+        vertices, edges and faces are numbered. Meshes that can be reordered
+        onto each other always have equal fingerprints; meshes with different
+        fingerprints never can.
+
+        valenceHash covers the face degree and vertex valence histograms.
+        refinedHash is the result of Weisfeiler-Lehman colour refinement over
+        the vertex/face incidence, and tells apart most meshes that share
+        their histograms.
+    */
+    struct TopologyFingerprint
+    {
+        int         numberOfVertices    = 0;
+        int         numberOfEdges       = 0;
+        int         numberOfFaces       = 0;
+        int         numberOfCorners     = 0;
+
+        uint64_t    valenceHash         = 0;
+        uint64_t    refinedHash         = 0;
+
+        uint64_t    hash() const;
+
+        bool        operator== (const TopologyFingerprint &other) const;
+        bool        operator!= (const TopologyFingerprint &other) const { return !(*this == other); }
+    };
+
+    /**
+        Fingerprints a mesh given as Maya-style face vertex lists. Only the
+        faces are read, so this is much cheaper than building MeshData.
+    */
+    TopologyFingerprint getTopologyFingerprint(
+        int numVertices,
+        int numEdges,
+        const std::vector<int> &polyCounts,
+        const std::vector<int> &polyConnects,
+        int rounds = 3,
+        int numberOfThreads = 1
+    );
+
+    /**
+        Order-dependent hash of numberOfValues 32 bit values - ints or floats -
+        for telling whether an array has changed since it was last seen.
+    */
+    uint64_t hashValues(const void *values, size_t numberOfValues, uint64_t seed = 0, int numberOfThreads = 1);
+}
+
+#endif
@@ -0,0 +1,155 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "topologyPath.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+
+TopologyPath::TopologyPath() {}
+
+
+TopologyPath::TopologyPath(int &numberOfComponents)
+{
+    this->resize(numberOfComponents);
+}
+
+
+TopologyPath::~TopologyPath() {}
+
+
+void TopologyPath::resize(int &numberOfComponents)
+{
+    indexVisitOrder.assign(numberOfComponents, -1);
+    componentShellId.assign(numberOfComponents, 0);
+    visitedIndices.assign(numberOfComponents, -1);
+
+    nextToVisit.assign(numberOfComponents, -1);
+    queued.assign(numberOfComponents, 0);
+}
+
+
+bool TopologyPath::visit(int &index, int &shellId, PathCursor &cursor)
+{
+    bool result = false;
+
+    if (!visited(index)) 
+    { 
+        int position = cursor.visitBase + cursor.numVisited++;
+
+        visitedIndices[position] = index;
+        indexVisitOrder[index] = position;
+        result =  true;
+
+        componentShellId[index] = shellId;
+    }    
+
+    return result;
+}
+
+
+bool TopologyPath::visited(int &index)
+{
+    return indexVisitOrder[index] != -1;
+}
+
+
+int TopologyPath::visitedAt(int &index)
+{
+    return indexVisitOrder[index];
+}
+
+
+int TopologyPath::shellId(int &index)
+{
+    return componentShellId[index];
+}
+
+
+void TopologyPath::push(int &index, PathCursor &cursor)
+{
+    if (queued[index]) { return; }
+
+    queued[index] = 1;
+
+    int queueTail = cursor.queueHead + cursor.queueSize++;
+
+    if (queueTail >= cursor.queueCapacity)
+    {
+        queueTail -= cursor.queueCapacity;
+    }
+
+    nextToVisit[cursor.queueBase + queueTail] = index;
+}
+
+
+bool TopologyPath::empty(PathCursor &cursor)
+{
+    return cursor.queueSize == 0;
+}
+
+
+int TopologyPath::next(PathCursor &cursor)
+{
+    int result = -1;
+
+    if (cursor.queueSize != 0)
+    {
+        result = nextToVisit[cursor.queueBase + cursor.queueHead++];
+        cursor.queueSize--;
+
+        if (cursor.queueHead == cursor.queueCapacity)
+        {
+            cursor.queueHead = 0;
+        }
+    }
+
+    return result;
+}
+
+
+/**
+    Rewrites the visit order as the given [first, last) slices of it, one after
+    another, and returns how many indices that adds up to. Used to stitch
+    together walks that were run in separate windows.
+*/
+int TopologyPath::collect(const std::vector<std::pair<int, int>> &segments)
+{
+    std::vector<int> visitOrder;
+    visitOrder.reserve(visitedIndices.size());
+
+    for (const std::pair<int, int> &segment : segments)
+    {
+        for (int i = segment.first; i < segment.second; i++)
+        {
+            visitOrder.push_back(visitedIndices[i]);
+        }
+    }
+
+    int numVisited = (int) visitOrder.size();
+
+    std::fill(visitedIndices.begin(), visitedIndices.end(), -1);
+
+    for (int i = 0; i < numVisited; i++)
+    {
+        visitedIndices[i] = visitOrder[i];
+        indexVisitOrder[visitOrder[i]] = i;
+    }
+
+    return numVisited;
+}
+
+
+size_t TopologyPath::memoryUsage() const
+{
+    return (
+          visitedIndices.capacity() 
+        + componentShellId.capacity() 
+        + indexVisitOrder.capacity() 
+        + nextToVisit.capacity()
+    ) * sizeof(int) + queued.capacity();
+}
@@ -0,0 +1,66 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#ifndef YANTOR3D_TOPOLOGY_PATH_H
+#define YANTOR3D_TOPOLOGY_PATH_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+    Where one walk writes its visits and keeps its queue. A walk over the whole
+    mesh owns every index; concurrent walks over disjoint shells each get their
+    own window so they never write to the same slots.
+*/
+struct PathCursor
+{
+    int                 visitBase       = 0;
+    int                 numVisited      = 0;
+
+    int                 queueBase       = 0;
+    int                 queueCapacity   = 0;
+    int                 queueHead       = 0;
+    int                 queueSize       = 0;
+};
+
+class TopologyPath
+{
+public:
+                        TopologyPath();
+                        TopologyPath(int &numberOfComponents);
+    virtual             ~TopologyPath();
+    
+    void                resize(int &numberOfComponents);
+
+    bool                visit(int &index, int &shellId, PathCursor &cursor);
+    bool                visited(int &index);
+    int                 visitedAt(int &index);
+    int                 shellId(int &index);
+
+    bool                empty(PathCursor &cursor);
+    int                 next(PathCursor &cursor);
+    void                push(int &index, PathCursor &cursor);
+
+    int                 collect(const std::vector<std::pair<int, int>> &segments);
+
+    size_t              memoryUsage() const;
+
+    int&                operator[] (int i) { return visitedIndices[i]; }
+
+private:
+    std::vector<int>    visitedIndices;
+    std::vector<int>    componentShellId;
+    std::vector<int>    indexVisitOrder;
+
+    /**
+        Ring buffer of indices waiting to be visited. An index is only ever
+        queued once, so it never needs more room than there are components.
+    */
+    std::vector<int>    nextToVisit;
+    std::vector<char>   queued;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,261 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+/**
+    Checks that walking a mesh that has already been set allocates nothing -
+    the walk's queue is a ring buffer sized by setMesh, and reset only clears
+    what the last walk visited. Counts every operator new during reset and a
+    walk from each shell of a mesh of a quad grid, a grid with triangles and
+    a cube, a few times over, and exits non-zero if any were made.
+
+    Usage: polyReorderWalkAllocationTest [gridSize]
+*/
+
+#include "componentSelection.h"
+#include "meshTopology.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+    bool    isCounting          = false;
+    long    numberOfAllocations = 0;
+
+    /**
+        The arrays setMesh takes, grown one shell at a time.
+    */
+    struct TestMesh
+    {
+        int                 numVertices = 0;
+
+        std::vector<int>    polyCounts;
+        std::vector<int>    polyConnects;
+        std::vector<int>    edgeVertices;
+    };
+
+    /**
+        Adds a grid of size x size faces. Every third face of a grid with
+        triangles is split into two.
+    */
+    void addGrid(TestMesh &mesh, int size, bool withTriangles)
+    {
+        int firstVertex = mesh.numVertices;
+        int rowLength = size + 1;
+
+        for (int y = 0; y < size; y++)
+        {
+            for (int x = 0; x < size; x++)
+            {
+                int corner = firstVertex + y * rowLength + x;
+
+                int a = corner;
+                int b = corner + 1;
+                int c = corner + rowLength + 1;
+                int d = corner + rowLength;
+
+                if (withTriangles && (x + y) % 3 == 0)
+                {
+                    mesh.polyCounts.push_back(3);
+                    mesh.polyConnects.insert(mesh.polyConnects.end(), {a, b, c});
+                    mesh.polyCounts.push_back(3);
+                    mesh.polyConnects.insert(mesh.polyConnects.end(), {a, c, d});
+                } else {
+                    mesh.polyCounts.push_back(4);
+                    mesh.polyConnects.insert(mesh.polyConnects.end(), {a, b, c, d});
+                }
+            }
+        }
+
+        mesh.numVertices += rowLength * rowLength;
+    }
+
+    void addCube(TestMesh &mesh)
+    {
+        const int faces[] = {0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4};
+
+        for (int f = 0; f < 6; f++)
+        {
+            mesh.polyCounts.push_back(4);
+
+            for (int i = 0; i < 4; i++)
+            {
+                mesh.polyConnects.push_back(mesh.numVertices + faces[f * 4 + i]);
+            }
+        }
+
+        mesh.numVertices += 8;
+    }
+
+    /**
+        Numbers the edges in the order the faces first reach them.
+    */
+    void addEdges(TestMesh &mesh)
+    {
+        std::map<std::pair<int, int>, int> edges;
+
+        mesh.edgeVertices.clear();
+
+        int firstCorner = 0;
+
+        for (int faceSize : mesh.polyCounts)
+        {
+            for (int i = 0; i < faceSize; i++)
+            {
+                int a = mesh.polyConnects[firstCorner + i];
+                int b = mesh.polyConnects[firstCorner + (i + 1) % faceSize];
+
+                std::pair<int, int> key(std::min(a, b), std::max(a, b));
+
+                if (edges.count(key) == 0)
+                {
+                    edges[key] = (int) mesh.edgeVertices.size() / 2;
+                    mesh.edgeVertices.push_back(a);
+                    mesh.edgeVertices.push_back(b);
+                }
+            }
+
+            firstCorner += faceSize;
+        }
+    }
+
+    /**
+        Starts a walk at the first corner of face, along the edge to the next.
+    */
+    polyReorder::ComponentSelection getSeed(const TestMesh &mesh, int face)
+    {
+        int firstCorner = 0;
+
+        for (int f = 0; f < face; f++)
+        {
+            firstCorner += mesh.polyCounts[f];
+        }
+
+        int a = mesh.polyConnects[firstCorner];
+        int b = mesh.polyConnects[firstCorner + 1];
+
+        polyReorder::ComponentSelection seed;
+        seed.faceIndex = face;
+        seed.vertexIndex = a;
+        seed.edgeIndex = -1;
+
+        for (size_t e = 0; e < mesh.edgeVertices.size() / 2; e++)
+        {
+            int v0 = mesh.edgeVertices[e * 2];
+            int v1 = mesh.edgeVertices[e * 2 + 1];
+
+            if ((v0 == a && v1 == b) || (v0 == b && v1 == a))
+            {
+                seed.edgeIndex = (int) e;
+                break;
+            }
+        }
+
+        return seed;
+    }
+}
+
+
+void* operator new(size_t size)
+{
+    if (isCounting)
+    {
+        numberOfAllocations++;
+    }
+
+    void *memory = std::malloc(size == 0 ? 1 : size);
+
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return memory;
+}
+
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+
+void operator delete(void *memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+
+int main(int argc, char **argv)
+{
+    int gridSize = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 300;
+
+    TestMesh mesh;
+    std::vector<int> shellFaces;
+
+    shellFaces.push_back((int) mesh.polyCounts.size());
+    addGrid(mesh, gridSize, false);
+
+    shellFaces.push_back((int) mesh.polyCounts.size());
+    addGrid(mesh, gridSize / 2 + 1, true);
+
+    shellFaces.push_back((int) mesh.polyCounts.size());
+    addCube(mesh);
+
+    addEdges(mesh);
+
+    std::vector<polyReorder::ComponentSelection> seeds;
+
+    for (int face : shellFaces)
+    {
+        seeds.push_back(getSeed(mesh, face));
+    }
+
+    MeshTopology meshTopology;
+
+    if (!meshTopology.setMesh(mesh.numVertices, mesh.polyCounts, mesh.polyConnects, mesh.edgeVertices))
+    {
+        fprintf(stderr, "setMesh failed.\n");
+        return 1;
+    }
+
+    bool succeeded = true;
+
+    for (int pass = 0; pass < 3; pass++)
+    {
+        numberOfAllocations = 0;
+        isCounting = true;
+
+        meshTopology.reset();
+
+        for (polyReorder::ComponentSelection &seed : seeds)
+        {
+            meshTopology.walk(seed);
+        }
+
+        isCounting = false;
+
+        bool isComplete = meshTopology.isComplete();
+
+        printf(
+            "pass %d: %d vertices, %d shells, complete %s, %ld allocations\n",
+            pass,
+            mesh.numVertices,
+            (int) seeds.size(),
+            isComplete ? "yes" : "no",
+            numberOfAllocations
+        );
+
+        succeeded = succeeded && isComplete && numberOfAllocations == 0;
+    }
+
+    return succeeded ? 0 : 1;
+}
@@ -5,7 +5,10 @@
 
 #include "parseArgs.h"
 
+#include <vector>
+
 #include <maya/MArgDatabase.h>
+#include <maya/MArgList.h>
 #include <maya/MDagPath.h>
 #include <maya/MFnDagNode.h>
 #include <maya/MGlobal.h>
@@ -65,6 +68,46 @@ MStatus parseArgs::getDagPathArgument(MArgDatabase &argsData, const char* flag,
 }
 
 
+/**
+    Reads every use of a multi-use flag that names one DAG node.
+*/
+MStatus parseArgs::getDagPathArguments(MArgDatabase &argsData, const char* flag, std::vector<MDagPath> &paths)
+{
+    MStatus status;
+
+    uint numberOfUses = argsData.numberOfFlagUses(flag);
+
+    paths.resize(numberOfUses);
+
+    for (uint i = 0; i < numberOfUses; i++)
+    {
+        MArgList args;
+
+        status = argsData.getFlagArgumentList(flag, i, args);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        MString objectName = args.asString(0, &status);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        MSelectionList selection;
+        status = selection.add(objectName);
+
+        if (!status)
+        {
+            MString errorMsg("Object '^1s'' does not exist.");
+            errorMsg.format(errorMsg, objectName);
+            MGlobal::displayError(errorMsg);
+            return status;
+        }
+
+        status = selection.getDagPath(0, paths[i]);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+    }
+
+    return MStatus::kSuccess;
+}
+
+
 MStatus parseArgs::getComponentArgument(MSelectionList &selection, MFn::Type componentType, MDagPath &mesh, MObject &components)
 {
     MStatus status;
@@ -121,6 +164,44 @@ MStatus parseArgs::getBooleanArgument(MArgDatabase &argsData, const char* flag,
 }
 
 
+MStatus parseArgs::getIntArgument(MArgDatabase &argsData, const char* flag, int &value, int default_)
+{
+    MStatus status;
+
+    bool flagIsSet = argsData.isFlagSet(flag, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    if (flagIsSet)
+    {
+        status = argsData.getFlagArgument(flag, 0, value);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+    } else {
+        value = default_;
+    }
+    
+    return status;
+}
+
+
+MStatus parseArgs::getStringArgument(MArgDatabase &argsData, const char* flag, MString &value, MString default_)
+{
+    MStatus status;
+
+    bool flagIsSet = argsData.isFlagSet(flag, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    if (flagIsSet)
+    {
+        status = argsData.getFlagArgument(flag, 0, value);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+    } else {
+        value = default_;
+    }
+    
+    return status;
+}
+
+
 int parseArgs::getComponentIndex(MObject &component)
 {
     MFnSingleIndexedComponent sic(component);
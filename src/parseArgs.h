@@ -6,12 +6,15 @@
 #ifndef PARSE_ARGS_H
 #define PARSE_ARGS_H
 
+#include <vector>
+
 #include <maya/MArgDatabase.h>
 #include <maya/MDagPath.h>
 #include <maya/MFn.h>
 #include <maya/MObject.h>
 #include <maya/MSelectionList.h>
 #include <maya/MStatus.h>
+#include <maya/MString.h>
 
 namespace parseArgs
 {
@@ -20,8 +23,11 @@ namespace parseArgs
 
     MStatus getNodeArgument(MArgDatabase &argsData, const char* flag, MObject &node, bool required);
     MStatus getDagPathArgument(MArgDatabase &argsData, const char* flag, MDagPath &path, bool required);
+    MStatus getDagPathArguments(MArgDatabase &argsData, const char* flag, std::vector<MDagPath> &paths);
 
     MStatus getBooleanArgument(MArgDatabase &argsData, const char* flag, bool &value, bool default_=true);
+    MStatus getIntArgument(MArgDatabase &argsData, const char* flag, int &value, int default_=0);
+    MStatus getStringArgument(MArgDatabase &argsData, const char* flag, MString &value, MString default_=MString());
    
     bool isNodeType(MObject &node, MFn::Type nodeType);
     bool isNodeType(MDagPath &path, MFn::Type nodeType);
@@ -0,0 +1,100 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "phaseStatistics.h"
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <maya/MString.h>
+#include <maya/MStringArray.h>
+#include <maya/MTypes.h>
+
+#if MAYA_API_VERSION >= 201600
+#include <maya/MProfiler.h>
+#endif
+
+
+#if MAYA_API_VERSION >= 201600
+namespace
+{
+    /**
+        Registered the first time a phase runs. Static initialisation is
+        thread safe, so nodes evaluating in parallel may race to it.
+    */
+    int profilerCategory()
+    {
+        static int category = MProfiler::addCategory("polyReorder", "polyReorder command and node phases");
+        return category;
+    }
+}
+#endif
+
+
+void PhaseStatistics::clear()
+{
+    values.clear();
+}
+
+
+void PhaseStatistics::addTime(const char *phase, double milliseconds)
+{
+    for (std::pair<std::string, double> &value : values)
+    {
+        if (value.first == phase)
+        {
+            value.second += milliseconds;
+            return;
+        }
+    }
+
+    values.push_back(std::make_pair(std::string(phase), milliseconds));
+}
+
+
+void PhaseStatistics::addValue(const char *name, double value)
+{
+    addTime(name, value);
+}
+
+
+void PhaseStatistics::getResult(MStringArray &result) const
+{
+    for (const std::pair<std::string, double> &value : values)
+    {
+        MString number;
+        number += value.second;
+
+        result.append(MString(value.first.c_str()));
+        result.append(number);
+    }
+}
+
+
+PhaseScope::PhaseScope(const char *phase, PhaseStatistics *statistics) : 
+    phase(phase),
+    statistics(statistics),
+    start(std::chrono::steady_clock::now())
+{
+#if MAYA_API_VERSION >= 201600
+    eventId = MProfiler::eventBegin(profilerCategory(), MProfiler::kColorA_L1, phase);
+#endif
+}
+
+
+PhaseScope::~PhaseScope()
+{
+#if MAYA_API_VERSION >= 201600
+    MProfiler::eventEnd(eventId);
+#endif
+
+    if (statistics)
+    {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        statistics->addTime(phase, elapsed.count());
+    }
+}
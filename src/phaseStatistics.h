@@ -0,0 +1,60 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#ifndef YANTOR3D_PHASE_STATISTICS_H
+#define YANTOR3D_PHASE_STATISTICS_H
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <maya/MStringArray.h>
+
+/**
+    Named values gathered while the command runs - wall times in
+    milliseconds for each phase, and counters such as bytes and shells - in
+    the order they were first added. A name that is added more than once
+    adds up. It is not safe to add to from more than one thread.
+*/
+class PhaseStatistics
+{
+public:
+    void                clear();
+
+    void                addTime(const char *phase, double milliseconds);
+    void                addValue(const char *name, double value);
+
+    /**
+        Fills result with name, value pairs, which Python reads back with
+        dict(zip(result[::2], result[1::2])).
+    */
+    void                getResult(MStringArray &result) const;
+
+private:
+    std::vector<std::pair<std::string, double>> values;
+};
+
+
+/**
+    Times one phase from construction to destruction, and adds it to
+    statistics if there are any. The phase is reported to Maya's profiler
+    under the polyReorder category either way, so it shows up in the
+    Profiler window whenever that is recording.
+*/
+class PhaseScope
+{
+public:
+                        PhaseScope(const char *phase, PhaseStatistics *statistics=nullptr);
+                        ~PhaseScope();
+
+private:
+    const char                              *phase;
+    PhaseStatistics                         *statistics;
+    std::chrono::steady_clock::time_point   start;
+    int                                     eventId = -1;
+};
+
+#endif
@@ -3,6 +3,7 @@
     You may use, distribute, or modify this code under the terms of the MIT license.
 */
 
+#include "pointOrderData.h"
 #include "polyReorderCommand.h"
 #include "polyReorderNode.h"
 #include "polyReorderTool.h"
@@ -22,6 +23,9 @@ const char* kREQUIRED_API_VERSION = "Any";
 MString PolyReorderNode::NODE_NAME = "polyReorder";
 MTypeId PolyReorderNode::NODE_ID = 0x00126b0e;
 
+MString PointOrderData::TYPE_NAME = "polyReorderPointOrder";
+MTypeId PointOrderData::TYPE_ID = 0x00126b0f;
+
 MString PolyReorderCommand::COMMAND_NAME = "polyReorder";
 
 MString PolyReorderContextCmd::COMMAND_NAME = "polyReorderCtx";
@@ -48,6 +52,14 @@ MStatus initializePlugin(MObject obj)
         PolyReorderCommand::getSyntax
     );
 
+    status = fnPlugin.registerData(
+        PointOrderData::TYPE_NAME,
+        PointOrderData::TYPE_ID,
+        PointOrderData::creator
+    );
+
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
     status = fnPlugin.registerNode(
 	    PolyReorderNode::NODE_NAME,
         PolyReorderNode::NODE_ID,
@@ -89,6 +101,9 @@ MStatus uninitializePlugin(MObject obj)
     status = fnPlugin.deregisterNode(PolyReorderNode::NODE_ID);
     CHECK_MSTATUS_AND_RETURN_IT(status);
 
+    status = fnPlugin.deregisterData(PointOrderData::TYPE_ID);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
     if (MGlobal::mayaState() == MGlobal::kInteractive && menuCreated)
     {
         status = MGlobal::executePythonCommand("import polyReorder");
@@ -0,0 +1,153 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "pointOrderCodec.h"
+#include "pointOrderData.h"
+#include "topologyFingerprint.h"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include <maya/MArgList.h>
+#include <maya/MPxData.h>
+#include <maya/MString.h>
+#include <maya/MStatus.h>
+#include <maya/MTypeId.h>
+
+
+#define RETURN_IF_ERROR(s) if (!s) { return s; }
+
+
+PointOrderData::PointOrderData() {}
+
+
+PointOrderData::~PointOrderData() {}
+
+
+void* PointOrderData::creator()
+{
+    return new PointOrderData();
+}
+
+
+/**
+    Reads the number of codes followed by the codes themselves. A count
+    larger than the arguments left is rejected before anything is allocated.
+*/
+MStatus PointOrderData::readASCII(const MArgList &args, unsigned &lastElement)
+{
+    MStatus status;
+
+    int numberOfCodes = args.asInt(lastElement++, &status);
+    RETURN_IF_ERROR(status);
+
+    if (numberOfCodes < 0) { return MStatus::kFailure; }
+    if (lastElement > args.length() || (unsigned) numberOfCodes > args.length() - lastElement) { return MStatus::kFailure; }
+
+    std::vector<int> codes(numberOfCodes);
+
+    for (int &code : codes)
+    {
+        code = args.asInt(lastElement++, &status);
+        RETURN_IF_ERROR(status);
+    }
+
+    return setCodes(codes);
+}
+
+
+MStatus PointOrderData::readBinary(std::istream &in, unsigned length)
+{
+    if (length < sizeof(int)) { return MStatus::kFailure; }
+
+    int numberOfCodes = 0;
+    in.read((char*) &numberOfCodes, sizeof(int));
+
+    if (!in || numberOfCodes < 0) { return MStatus::kFailure; }
+    if ((unsigned) numberOfCodes > (length - sizeof(int)) / sizeof(int)) { return MStatus::kFailure; }
+
+    std::vector<int> codes(numberOfCodes);
+    in.read((char*) codes.data(), codes.size() * sizeof(int));
+
+    if (!in) { return MStatus::kFailure; }
+
+    return setCodes(codes);
+}
+
+
+MStatus PointOrderData::writeASCII(std::ostream &out)
+{
+    std::vector<int> codes;
+    polyReorder::encodePointOrder(order, codes);
+
+    out << codes.size();
+
+    for (int code : codes)
+    {
+        out << ' ' << code;
+    }
+
+    return out.fail() ? MStatus::kFailure : MStatus::kSuccess;
+}
+
+
+MStatus PointOrderData::writeBinary(std::ostream &out)
+{
+    std::vector<int> codes;
+    polyReorder::encodePointOrder(order, codes);
+
+    int numberOfCodes = (int) codes.size();
+
+    out.write((const char*) &numberOfCodes, sizeof(int));
+    out.write((const char*) codes.data(), codes.size() * sizeof(int));
+
+    return out.fail() ? MStatus::kFailure : MStatus::kSuccess;
+}
+
+
+void PointOrderData::copy(const MPxData &other)
+{
+    if (other.typeId() == TYPE_ID)
+    {
+        order = ((const PointOrderData&) other).order;
+        orderKey = ((const PointOrderData&) other).orderKey;
+    }
+}
+
+
+MTypeId PointOrderData::typeId() const
+{
+    return TYPE_ID;
+}
+
+
+MString PointOrderData::name() const
+{
+    return TYPE_NAME;
+}
+
+
+MStatus PointOrderData::setCodes(const std::vector<int> &codes)
+{
+    int numberOfCodes = (int) codes.size();
+    int numberOfIndices = polyReorder::decodedLength(codes.data(), numberOfCodes);
+
+    if (numberOfIndices == -1) { return MStatus::kFailure; }
+
+    order.resize(numberOfIndices);
+    polyReorder::decodePointOrder(codes.data(), numberOfCodes, order.data());
+
+    orderKey = polyReorder::hashValues(order.data(), order.size());
+
+    return MStatus::kSuccess;
+}
+
+
+void PointOrderData::setPointOrder(const std::vector<int> &pointOrder)
+{
+    order = pointOrder;
+    orderKey = polyReorder::hashValues(order.data(), order.size());
+}
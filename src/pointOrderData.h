@@ -0,0 +1,60 @@
+/**
+    Copyright (c) 2017 Ryan Porter    
+    You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#ifndef YANTOR3D_POINT_ORDER_DATA_H
+#define YANTOR3D_POINT_ORDER_DATA_H
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include <maya/MArgList.h>
+#include <maya/MPxData.h>
+#include <maya/MString.h>
+#include <maya/MStatus.h>
+#include <maya/MTypeId.h>
+
+/**
+    A pointOrder that is saved as runs of consecutive indices rather than one
+    integer per point - see polyReorder::encodePointOrder. It is decoded once,
+    when the file is read, into the std::vector the node reorders with, and
+    hashed once into the key the node caches its mesh against. The node reads
+    both in place, so neither is copied or recomputed on evaluation.
+*/
+class PointOrderData : public MPxData
+{
+public:
+                        PointOrderData();
+    virtual             ~PointOrderData();
+
+    static  void*       creator();
+
+    virtual MStatus     readASCII(const MArgList &args, unsigned &lastElement);
+    virtual MStatus     readBinary(std::istream &in, unsigned length);
+    virtual MStatus     writeASCII(std::ostream &out);
+    virtual MStatus     writeBinary(std::ostream &out);
+
+    virtual void        copy(const MPxData &other);
+
+    virtual MTypeId     typeId() const;
+    virtual MString     name() const;
+
+    const std::vector<int>& pointOrder() const { return order; }
+    uint64_t            pointOrderKey() const { return orderKey; }
+    void                setPointOrder(const std::vector<int> &pointOrder);
+
+private:
+    MStatus             setCodes(const std::vector<int> &codes);
+
+public:
+    static MString      TYPE_NAME;
+    static MTypeId      TYPE_ID;
+
+private:
+    std::vector<int>    order;
+    uint64_t            orderKey    = 0;
+};
+
+#endif
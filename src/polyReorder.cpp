@@ -3,41 +3,324 @@
     You may use, distribute, or modify this code under the terms of the MIT license.
 */
 
+#include "meshData.h"
+#include "meshReorder.h"
+#include "meshTopology.h"
+#include "phaseStatistics.h"
 #include "polyReorder.h"
 
 #include <vector>
 
+#include <maya/MDagPath.h>
+#include <maya/MDoubleArray.h>
+#include <maya/MFn.h>
 #include <maya/MFloatPointArray.h>
 #include <maya/MFloatVectorArray.h>
 #include <maya/MFnMesh.h>
+#include <maya/MFnMeshData.h>
 #include <maya/MGlobal.h>
 #include <maya/MIntArray.h>
-#include <maya/MItMeshEdge.h>
-#include <maya/MItMeshPolygon.h>
 #include <maya/MStatus.h>
-#include <maya/MPointArray.h>
+#include <maya/MStringArray.h>
+#include <maya/MTypes.h>
+#include <maya/MUintArray.h>
 #include <maya/MVectorArray.h>
 
 
 #define RETURN_IF_ERROR(s) if (!s) { return s; }
 
 
-MStatus polyReorder::getPoints(MObject &mesh, MIntArray &pointOrder, MPointArray &outPoints)
+MStatus polyReorder::getMeshArrays(MObject &mesh, int &numVertices, std::vector<int> &polyCounts, std::vector<int> &polyConnects, std::vector<int> &edgeVertices)
 {
+    MStatus status;
+
+    MFnMesh meshFn(mesh, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    MIntArray mPolyCounts;
+    MIntArray mPolyConnects;
+
+    status = meshFn.getVertices(mPolyCounts, mPolyConnects);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    numVertices = meshFn.numVertices();
+
+    polyCounts.resize(mPolyCounts.length());
+    polyConnects.resize(mPolyConnects.length());
+
+    mPolyCounts.get(polyCounts.data());
+    mPolyConnects.get(polyConnects.data());
+
+    status = polyReorder::getEdgeVertices(mesh, edgeVertices);
+    RETURN_IF_ERROR(status);
+
+    return MStatus::kSuccess;
+}
+
+
+MStatus polyReorder::getEdgeVertices(MObject &mesh, std::vector<int> &edgeVertices)
+{
+    MStatus status;
+
+    MFnMesh meshFn(mesh, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    int numEdges = meshFn.numEdges();
+
+    edgeVertices.resize(numEdges * 2);
+
+    for (int e = 0; e < numEdges; e++)
+    {
+        int2 ev;
+        meshFn.getEdgeVertices(e, ev);
+
+        edgeVertices[e * 2] = ev[0];
+        edgeVertices[e * 2 + 1] = ev[1];
+    }
+
+    return MStatus::kSuccess;
+}
+
+
+MStatus polyReorder::getMeshData(MDagPath &mesh, MeshData &meshData, Progress *progress)
+{
+    MStatus status;
+
+    int numVertices;
+    std::vector<int> polyCounts;
+    std::vector<int> polyConnects;
+    std::vector<int> edgeVertices;
+
+    MObject meshObj = mesh.node();
+
+    status = polyReorder::getMeshArrays(meshObj, numVertices, polyCounts, polyConnects, edgeVertices);
+    RETURN_IF_ERROR(status);
+
+    if (!meshData.unpackMesh(numVertices, polyCounts, polyConnects, edgeVertices, progress))
+    {
+        return MStatus::kFailure;
+    }
+
+    return MStatus::kSuccess;
+}
+
+
+MStatus polyReorder::getMeshTopology(MDagPath &mesh, MeshTopology &meshTopology, Progress *progress)
+{
+    MStatus status;
+
+    int numVertices;
+    std::vector<int> polyCounts;
+    std::vector<int> polyConnects;
+    std::vector<int> edgeVertices;
+
+    MObject meshObj = mesh.node();
+
+    status = polyReorder::getMeshArrays(meshObj, numVertices, polyCounts, polyConnects, edgeVertices);
+    RETURN_IF_ERROR(status);
+
+    if (!meshTopology.setMesh(numVertices, polyCounts, polyConnects, edgeVertices, progress))
+    {
+        return MStatus::kFailure;
+    }
+
+    return MStatus::kSuccess;
+}
+
+
+MStatus polyReorder::getTopologyFingerprint(MDagPath &mesh, TopologyFingerprint &fingerprint, int numberOfThreads)
+{
+    MStatus status;
+
+    MFnMesh meshFn(mesh, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    MIntArray mPolyCounts;
+    MIntArray mPolyConnects;
+
+    status = meshFn.getVertices(mPolyCounts, mPolyConnects);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    std::vector<int> polyCounts(mPolyCounts.length());
+    std::vector<int> polyConnects(mPolyConnects.length());
+
+    mPolyCounts.get(polyCounts.data());
+    mPolyConnects.get(polyConnects.data());
+
+    fingerprint = polyReorder::getTopologyFingerprint(
+        meshFn.numVertices(), 
+        meshFn.numEdges(), 
+        polyCounts, 
+        polyConnects, 
+        3, 
+        numberOfThreads
+    );
+
+    return MStatus::kSuccess;
+}
+
+
+/**
+    Cheap test for whether b could be a reordered copy of a. Counts are
+    compared first; only meshes that agree on those are fingerprinted.
+*/
+bool polyReorder::hasSameTopology(MDagPath &a, MDagPath &b, int numberOfThreads)
+{
+    MFnMesh fA(a);
+    MFnMesh fB(b);
+
+    bool countsMatch = (
+           fA.numVertices() == fB.numVertices()
+        && fA.numEdges()    == fB.numEdges()
+        && fA.numPolygons() == fB.numPolygons()
+    );
+
+    if (!countsMatch) { return false; }
+
+    TopologyFingerprint fingerprintA;
+
+    if (!polyReorder::getTopologyFingerprint(a, fingerprintA, numberOfThreads)) { return false; }
+
+    return polyReorder::hasSameTopology(fingerprintA, b, numberOfThreads);
+}
+
+
+/**
+    Compares b against a fingerprint taken earlier, so a mesh compared with
+    many others is only fingerprinted once.
+*/
+bool polyReorder::hasSameTopology(const TopologyFingerprint &a, MDagPath &b, int numberOfThreads)
+{
+    MFnMesh fB(b);
+
+    bool countsMatch = (
+           a.numberOfVertices == fB.numVertices()
+        && a.numberOfEdges    == fB.numEdges()
+        && a.numberOfFaces    == fB.numPolygons()
+    );
+
+    if (!countsMatch) { return false; }
+
+    TopologyFingerprint fingerprintB;
+
+    if (!polyReorder::getTopologyFingerprint(b, fingerprintB, numberOfThreads)) { return false; }
+
+    return a == fingerprintB;
+}
+
+
+/**
+    Reads the raw float positions of the mesh and moves them by pointOrder
+    straight into the array the output mesh is built from.
+*/
+MStatus polyReorder::getPoints(MObject &mesh, MIntArray &pointOrder, MFloatPointArray &outPoints, int numberOfThreads)
+{
+    std::vector<int> order(pointOrder.length());
+    pointOrder.get(order.data());
+
+    return polyReorder::getPoints(mesh, order, outPoints, numberOfThreads);
+}
+
+
+MStatus polyReorder::getPoints(MObject &mesh, const std::vector<int> &pointOrder, MFloatPointArray &outPoints, int numberOfThreads)
+{
+    MStatus status;
+
     MFnMesh meshFn(mesh);
 
     uint numVertices = meshFn.numVertices();
 
-    MPointArray inPoints(numVertices);
-    outPoints.setLength(numVertices);
+    if (pointOrder.size() != numVertices)
+    {
+        return MStatus::kFailure;
+    }
 
-    meshFn.getPoints(inPoints, MSpace::kObject);
-    
-    for (uint i = 0; i < numVertices; i++)
+    const float *points = meshFn.getRawPoints(&status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    std::vector<float> reorderedPoints;
+
+    polyReorder::reorderFloatPoints(points, pointOrder, reorderedPoints, numberOfThreads);
+
+    outPoints = MFloatPointArray((float (*)[4]) reorderedPoints.data(), numVertices);
+
+    return MStatus::kSuccess;
+}
+
+
+/**
+    Returns true if reordering leaves mesh with exactly the faces it has now,
+    so every channel other than the points already sits where it belongs.
+*/
+bool polyReorder::hasSameFaces(MObject &mesh, MIntArray &polyCounts, MIntArray &polyConnects, const ComponentOrder *componentOrder)
+{
+    MFnMesh meshFn(mesh);
+
+    MIntArray meshCounts;
+    MIntArray meshConnects;
+
+    meshFn.getVertices(meshCounts, meshConnects);
+
+    if (meshCounts.length() != polyCounts.length() || meshConnects.length() != polyConnects.length())
     {
-        outPoints.set(inPoints[i], pointOrder[i]);
+        return false;
     }
 
+    std::vector<int> counts(polyCounts.length());
+    std::vector<int> connects(polyConnects.length());
+    std::vector<int> currentCounts(meshCounts.length());
+    std::vector<int> currentConnects(meshConnects.length());
+
+    polyCounts.get(counts.data());
+    polyConnects.get(connects.data());
+    meshCounts.get(currentCounts.data());
+    meshConnects.get(currentConnects.data());
+
+    if (counts != currentCounts || connects != currentConnects)
+    {
+        return false;
+    }
+
+    return (
+           !componentOrder
+        || (   polyReorder::isIdentityOrder(componentOrder->faceOrder)
+            && polyReorder::isIdentityOrder(componentOrder->edgeOrder)
+            && polyReorder::isIdentityOrder(componentOrder->cornerOrder))
+    );
+}
+
+
+/**
+    Gives outMesh the points alone, copying the rest of targetMesh across
+    unchanged when it is not the mesh being edited.
+*/
+MStatus polyReorder::setPointsOnly(MObject &targetMesh, MFloatPointArray &points, MObject &outMesh, bool isMeshData)
+{
+    MStatus status;
+
+    MFnMesh outMeshFn;
+
+    if (isMeshData)
+    {
+        MObject copiedMesh = outMeshFn.copy(targetMesh, outMesh, &status);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        status = outMeshFn.setObject(copiedMesh);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+    } else {
+        status = outMeshFn.setObject(outMesh);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        if (outMesh != targetMesh)
+        {
+            status = outMeshFn.copyInPlace(targetMesh);
+            CHECK_MSTATUS_AND_RETURN_IT(status);
+        }
+    }
+
+    status = outMeshFn.setPoints(points, MSpace::kObject);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
     return MStatus::kSuccess;
 }
 
@@ -49,10 +332,16 @@ MStatus polyReorder::getPolys(MObject &mesh, MIntArray &pointOrder, MIntArray &p
 
     if (reorderPoints)
     {
-        for (uint i = 0; i < polyConnects.length(); i++)
-        {
-            polyConnects[i] = pointOrder[polyConnects[i]];
-        }
+        std::vector<int> connects(polyConnects.length());
+        std::vector<int> reorderedConnects;
+        std::vector<int> order(pointOrder.length());
+
+        polyConnects.get(connects.data());
+        pointOrder.get(order.data());
+
+        polyReorder::reorderPolys(connects, order, reorderedConnects);
+
+        polyConnects = MIntArray(reorderedConnects.data(), (uint) reorderedConnects.size());
     }
 
     return MStatus::kSuccess;
@@ -80,21 +369,23 @@ void polyReorder::getFaceVertexList(MIntArray &polyCounts, MIntArray &polyConnec
 }
 
 
-MStatus polyReorder::getFaceVertexNormals(MObject &mesh, MVectorArray &vertexNormals)
+/**
+    Reads every normal of the mesh and the normal id of every face corner,
+    in polyConnects order.
+*/
+MStatus polyReorder::getFaceVertexNormals(MObject &mesh, MFloatVectorArray &normals, MIntArray &normalIds)
 {
     MStatus status;
 
-    uint i = 0;
+    MFnMesh meshFn(mesh);
 
-    for (MItMeshPolygon itPoly(mesh); !itPoly.isDone(); itPoly.next())
-    {
-        uint numVertices = itPoly.polygonVertexCount();
+    MIntArray normalCounts;
 
-        for (uint v = 0; v < numVertices; v++, i++)
-        {
-            itPoly.getNormal(v, vertexNormals[i], MSpace::kObject);
-        }
-    }
+    status = meshFn.getNormals(normals, MSpace::kObject);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    status = meshFn.getNormalIds(normalCounts, normalIds);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
 
     return MStatus::kSuccess;
 }
@@ -120,30 +411,63 @@ MStatus polyReorder::setFaceVertexNormals(MObject &mesh, MIntArray &polyCounts,
     return MStatus::kSuccess;
 }
 
-MStatus polyReorder::getFaceVertexLocks(MObject &mesh, MIntArray &lockedList)
+/**
+    Reads the lock state of each normal, rather than of each face corner - a
+    mesh with soft edges shares most of its normals between corners.
+*/
+MStatus polyReorder::getNormalLocks(MObject &mesh, MIntArray &normalIds, MIntArray &lockedNormals)
 {
-    MStatus status;
-
     MFnMesh meshFn(mesh);
 
-    MIntArray normalCounts;
-    MIntArray normalIds;
-
-    status = meshFn.getNormalIds(normalCounts, normalIds);
-    CHECK_MSTATUS_AND_RETURN_IT(status);
+    uint numNormals = (uint) meshFn.numNormals();
+    uint numIds = normalIds.length();
 
-    uint numNormals = normalIds.length();
+    lockedNormals = MIntArray(numNormals, -1);
 
-    lockedList.setLength(numNormals);
-
-    for (uint i = 0; i < numNormals; i++)
+    for (uint i = 0; i < numIds; i++)
     {
-        lockedList[i] = meshFn.isNormalLocked(normalIds[i]);
+        int &locked = lockedNormals[normalIds[i]];
+
+        if (locked == -1)
+        {
+            locked = meshFn.isNormalLocked(normalIds[i]);
+        }
     }
 
     return MStatus::kSuccess;
 }
 
+
+/**
+    Expands the normals and their lock states to one per face corner.
+*/
+void polyReorder::gatherFaceVertexNormals(
+    MFloatVectorArray &normals, 
+    MIntArray &normalIds, 
+    MIntArray &lockedNormals, 
+    MVectorArray &vertexNormals, 
+    MIntArray &lockedList
+) {
+    std::vector<float> inNormals(normals.length() * 3);
+    std::vector<float> outNormals;
+
+    std::vector<int> inLocks(lockedNormals.length());
+    std::vector<int> outLocks;
+
+    std::vector<int> ids(normalIds.length());
+
+    normals.get((float (*)[3]) inNormals.data());
+    lockedNormals.get(inLocks.data());
+    normalIds.get(ids.data());
+
+    polyReorder::gatherValues(inNormals, ids, 3, outNormals);
+    polyReorder::gatherValues(inLocks, ids, 1, outLocks);
+
+    vertexNormals = MVectorArray((float (*)[3]) outNormals.data(), (uint) ids.size());
+    lockedList = MIntArray(outLocks.data(), (uint) outLocks.size());
+}
+
+
 MStatus polyReorder::setFaceVertexLocks(MObject &mesh, MIntArray &lockedList)
 {
     MStatus status;
@@ -206,50 +530,208 @@ MStatus polyReorder::setFaceVertexLocks(MObject &mesh, MIntArray &lockedList)
 }
 
 
-MStatus polyReorder::getEdgeSmoothing(MObject &mesh, MIntArray &pointOrder, std::unordered_map<uint64_t, bool> &edgeSmoothing)
+MStatus polyReorder::getEdgeSmoothing(MObject &mesh, MIntArray &edgeSmoothing)
+{
+    MFnMesh meshFn(mesh);
+
+    int numEdges = meshFn.numEdges();
+
+    edgeSmoothing.setLength(numEdges);
+
+    for (int e = 0; e < numEdges; e++)
+    {
+        edgeSmoothing[e] = meshFn.isEdgeSmooth(e);
+    }
+
+    return MStatus::kSuccess;
+}
+
+
+/**
+    Sets edge e of mesh from edgeSmoothing[e], so edgeSmoothing must already
+    be in mesh's own edge numbering - moved by an edgeOrder only when that
+    names mesh's edges, and by matchEdgeSmoothing otherwise. Fails without
+    setting anything if there is not one value per edge.
+*/
+MStatus polyReorder::setEdgeSmoothing(MObject &mesh, MIntArray &edgeSmoothing)
 {
     MStatus status;
 
-    MItMeshEdge itEdge(mesh);
+    MFnMesh meshFn(mesh);
+
+    int numEdges = (int) edgeSmoothing.length();
+
+    if (numEdges != meshFn.numEdges())
+    {
+        return MStatus::kFailure;
+    }
+
+#if MAYA_API_VERSION >= 201600
+    MIntArray edgeIds(numEdges);
+
+    for (int e = 0; e < numEdges; e++)
+    {
+        edgeIds[e] = e;
+    }
 
-    while (!itEdge.isDone())
+    status = meshFn.setEdgeSmoothings(edgeIds, edgeSmoothing);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+#else
+    for (int e = 0; e < numEdges; e++)
     {
-        int v0 = pointOrder[itEdge.index(0)];
-        int v1 = pointOrder[itEdge.index(1)];
+        status = meshFn.setEdgeSmoothing(e, edgeSmoothing[e] != 0);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+    }
+#endif
 
-        uint64_t edgeKey = polyReorder::twoIntKey(v0, v1);
+    return MStatus::kSuccess;
+}
 
-        edgeSmoothing.emplace(edgeKey, itEdge.isSmooth());
 
-        itEdge.next();
+/**
+    Moves edgeSmoothing from edgeVertices, the edges a mesh had before it was
+    rebuilt, onto outEdgeVertices, the edges it has after, by matching their
+    end points.
+*/
+MStatus polyReorder::matchEdgeSmoothing(
+    const std::vector<int> &edgeVertices, 
+    MIntArray &pointOrder, 
+    const std::vector<int> &outEdgeVertices, 
+    MIntArray &edgeSmoothing
+) {
+    std::vector<int> order(pointOrder.length());
+    std::vector<int> edgeOrder;
+
+    pointOrder.get(order.data());
+
+    if (!polyReorder::getEdgeOrder(edgeVertices, order, outEdgeVertices, edgeOrder))
+    {
+        return MStatus::kFailure;
     }
 
+    polyReorder::reorderArray(edgeSmoothing, edgeOrder);
+
     return MStatus::kSuccess;
 }
 
 
-MStatus polyReorder::setEdgeSmoothing(MObject &mesh, std::unordered_map<uint64_t, bool> &edgeSmoothing)
+/**
+    Keys the mesh on its face-vertex lists, its normal ids and the UV ids
+    assigned to each face of every UV set. Point positions, UV positions,
+    normal directions and normal locks are left out - none can be read
+    without going over every element one query at a time - so a deformed
+    mesh keeps its key, and so does one whose UVs alone are animated.
+*/
+MStatus polyReorder::getMeshKey(MObject &mesh, MeshKey &key, int numberOfThreads)
 {
     MStatus status;
 
-    MItMeshEdge itEdge(mesh);
+    MeshKeyArrays arrays;
 
-    while (!itEdge.isDone())
+    status = getMeshKeyArrays(mesh, arrays);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    key = getMeshKey(arrays, numberOfThreads);
+
+    return MStatus::kSuccess;
+}
+
+
+MStatus polyReorder::getMeshKeyArrays(MObject &mesh, MeshKeyArrays &arrays)
+{
+    MStatus status;
+
+    MFnMesh meshFn(mesh, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    MIntArray counts;
+    MIntArray ids;
+
+    status = meshFn.getVertices(counts, ids);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    arrays.numVertices = meshFn.numVertices();
+    arrays.polyCounts.resize(counts.length());
+    arrays.polyConnects.resize(ids.length());
+
+    counts.get(arrays.polyCounts.data());
+    ids.get(arrays.polyConnects.data());
+
+    status = meshFn.getNormalIds(counts, ids);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    arrays.numNormals = meshFn.numNormals();
+    arrays.normalIds.resize(ids.length());
+
+    ids.get(arrays.normalIds.data());
+
+    MStringArray uvSetNames;
+
+    status = meshFn.getUVSetNames(uvSetNames);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    std::vector<int> &uvs = arrays.uvAssignments;
+    uvs.clear();
+
+    for (uint i = 0; i < uvSetNames.length(); i++)
     {
-        int v0 = itEdge.index(0);
-        int v1 = itEdge.index(1);
+        MString &name = uvSetNames[i];
+
+        status = meshFn.getAssignedUVs(counts, ids, &name);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        const char *nameChars = name.asChar();
 
-        uint64_t edgeKey = polyReorder::twoIntKey(v0, v1);
+        uvs.push_back(meshFn.numUVs(name));
+        uvs.push_back((int) name.length());
+        uvs.insert(uvs.end(), nameChars, nameChars + name.length());
 
-        itEdge.setSmoothing(edgeSmoothing[edgeKey]);
+        size_t offset = uvs.size();
+        uvs.resize(offset + counts.length() + ids.length());
 
-        itEdge.next();
+        counts.get(uvs.data() + offset);
+        ids.get(uvs.data() + offset + counts.length());
     }
 
     return MStatus::kSuccess;
 }
 
 
+polyReorder::MeshKey polyReorder::getMeshKey(const MeshKeyArrays &arrays, int numberOfThreads)
+{
+    MeshKey key;
+
+    key.numVertices = arrays.numVertices;
+
+    key.topology = hashValues(arrays.polyCounts.data(), arrays.polyCounts.size(), 0, numberOfThreads);
+    key.topology = hashValues(arrays.polyConnects.data(), arrays.polyConnects.size(), key.topology, numberOfThreads);
+
+    key.normals = hashValues(arrays.normalIds.data(), arrays.normalIds.size(), (uint64_t) arrays.numNormals, numberOfThreads);
+
+    key.uvs = hashValues(arrays.uvAssignments.data(), arrays.uvAssignments.size(), 0, numberOfThreads);
+
+    return key;
+}
+
+
+uint64_t polyReorder::hashArray(const MIntArray &values, uint64_t seed, int numberOfThreads)
+{
+    std::vector<int> buffer(values.length());
+    values.get(buffer.data());
+
+    return hashValues(buffer.data(), buffer.size(), seed, numberOfThreads);
+}
+
+
+uint64_t polyReorder::hashArray(const MFloatArray &values, uint64_t seed, int numberOfThreads)
+{
+    std::vector<float> buffer(values.length());
+    values.get(buffer.data());
+
+    return hashValues(buffer.data(), buffer.size(), seed, numberOfThreads);
+}
+
+
 MStatus polyReorder::getUVs(MObject &mesh, std::vector<UVSetData> &uvSets)
 {
     MStatus status;
@@ -308,85 +790,398 @@ MStatus polyReorder::setUVs(MObject &mesh, std::vector<UVSetData> &uvSets)
 }
 
 
-MStatus polyReorder::reorderMesh(MObject &sourceMesh, MObject &targetMesh, MIntArray &pointOrder, MObject &outMesh, bool isMeshData)
+void polyReorder::reorderArray(MIntArray &values, const std::vector<int> &order)
 {
-    MStatus status;
+    std::vector<int> inValues(values.length());
+    std::vector<int> outValues;
 
-    MFnMesh srcMeshFn(sourceMesh);
-    MFnMesh tgtMeshFn(targetMesh);
+    values.get(inValues.data());
 
-    uint numVertices = srcMeshFn.numVertices();
-    uint numPolys = srcMeshFn.numPolygons();
+    polyReorder::reorderValues(inValues, order, 1, outValues);
 
-    MPointArray points;
+    values = MIntArray(outValues.data(), (uint) outValues.size());
+}
+
+
+void polyReorder::reorderUVs(std::vector<UVSetData> &uvSets, MIntArray &polyCounts, const ComponentOrder &componentOrder)
+{
+    std::vector<int> faceSizes(polyCounts.length());
+    polyCounts.get(faceSizes.data());
+
+    for (UVSetData &uvData : uvSets)
+    {
+        std::vector<int> uvCounts(uvData.uvCounts.length());
+        std::vector<int> uvIds(uvData.uvIds.length());
+        std::vector<int> reorderedCounts;
+        std::vector<int> reorderedIds;
+
+        uvData.uvCounts.get(uvCounts.data());
+        uvData.uvIds.get(uvIds.data());
+
+        polyReorder::reorderFaceVertexIds(uvCounts, uvIds, faceSizes, componentOrder, reorderedCounts, reorderedIds);
+
+        uvData.uvCounts = MIntArray(reorderedCounts.data(), (uint) reorderedCounts.size());
+        uvData.uvIds = MIntArray(reorderedIds.data(), (uint) reorderedIds.size());
+    }
+}
+
+
+/**
+    Rebuilds targetMesh with the connectivity of sourceMesh. When a
+    componentOrder is given the output faces are in source order, and every
+    face-varying and per-edge channel of the target is moved across with it.
+    Without one, the output keeps the face order of the target. If the faces
+    come out exactly as the target has them, only the points are updated.
+    When sourceMesh is targetMesh its own faces are renumbered through
+    pointOrder, so an order can be applied without the source at hand.
+
+    Each step is timed into statistics, if given, and reported to Maya's
+    profiler. If progress is cancelled before outMesh is written this
+    returns kFailure and leaves outMesh as it was; once writing has begun it
+    runs to the end.
+*/
+MStatus polyReorder::reorderMesh(
+    MObject &sourceMesh, 
+    MObject &targetMesh, 
+    MIntArray &pointOrder, 
+    MObject &outMesh, 
+    bool isMeshData, 
+    const ComponentOrder *componentOrder,
+    PhaseStatistics *statistics,
+    Progress *progress
+) {
     MIntArray polyCounts;
     MIntArray polyConnects;
 
+    polyReorder::beginPhase(progress, "reorderMesh", 4);
+
+    {
+        PhaseScope scope("reorderFaces", statistics);
+        polyReorder::getPolys(sourceMesh, pointOrder, polyCounts, polyConnects, sourceMesh == targetMesh);
+    }
+
+    if (!polyReorder::advance(progress, 1))
+    {
+        return MStatus::kFailure;
+    }
+
+    return polyReorder::rebuildMesh(targetMesh, pointOrder, polyCounts, polyConnects, outMesh, isMeshData, componentOrder, statistics, progress);
+}
+
+
+/**
+    Builds outMesh from the points of targetMesh moved by pointOrder and the
+    given faces, carrying UVs, normals and edge smoothing across.
+
+    Maya numbers the edges of the new mesh itself, so the edgeOrder of
+    componentOrder only names them if it happens to number them the same
+    way. Edge smoothing follows the edgeOrder when the edges outMesh ends up
+    with run between the points the edgeOrder says they do; otherwise, or
+    without an edgeOrder, edges are matched on their end points.
+*/
+MStatus polyReorder::rebuildMesh(
+    MObject &targetMesh, 
+    MIntArray &pointOrder, 
+    MIntArray &polyCounts, 
+    MIntArray &polyConnects, 
+    MObject &outMesh, 
+    bool isMeshData, 
+    const ComponentOrder *componentOrder,
+    PhaseStatistics *statistics,
+    Progress *progress
+) {
+    MStatus status;
+
+    MFnMesh tgtMeshFn(targetMesh);
+
+    uint numVertices = tgtMeshFn.numVertices();
+    uint numPolys = polyCounts.length();
+
+    MFloatPointArray points;
+
     MIntArray faceList;
     MIntArray vertexList;
     MIntArray lockedList;
 
+    MFloatVectorArray normals;
+    MIntArray normalIds;
+    MIntArray lockedNormals;
+
     MVectorArray vertexNormals;
+    MIntArray edgeSmoothing;
 
-    std::unordered_map<uint64_t, bool> edgeSmoothing;
     std::vector<UVSetData> uvSets;
+    std::vector<int> edgeVertices;
+    std::vector<int> orderedEdgeVertices;
 
-    polyReorder::getPoints(targetMesh, pointOrder, points);
-    polyReorder::getPolys(sourceMesh, pointOrder, polyCounts, polyConnects, isMeshData);
+    {
+        PhaseScope scope("reorderPoints", statistics);
 
-    vertexNormals.setLength(polyConnects.length());
+        status = polyReorder::getPoints(targetMesh, pointOrder, points);
+        RETURN_IF_ERROR(status);
+    }
 
-    polyReorder::getFaceVertexNormals(targetMesh, vertexNormals);
-    polyReorder::getFaceVertexLocks(targetMesh, lockedList);
-    polyReorder::getEdgeSmoothing(targetMesh, pointOrder, edgeSmoothing);
-    polyReorder::getUVs(targetMesh, uvSets);
+    if (!polyReorder::advance(progress, 1))
+    {
+        return MStatus::kFailure;
+    }
 
-    if (isMeshData)
+    if (polyReorder::hasSameFaces(targetMesh, polyCounts, polyConnects, componentOrder))
     {
-        MFnMesh outMeshFn;
+        PhaseScope scope("setPoints", statistics);
+        return polyReorder::setPointsOnly(targetMesh, points, outMesh, isMeshData);
+    }
 
-        outMeshFn.create(
-            numVertices, 
-            numPolys,
-            points,
-            polyCounts,
-            polyConnects,
-            outMesh,
-            &status
-        );
+    {
+        PhaseScope scope("readChannels", statistics);
 
-        CHECK_MSTATUS_AND_RETURN_IT(status);
-    } else {
-        MFnMesh outMeshFn(outMesh);
-        MFloatPointArray floatPoints(numVertices);
+        status = polyReorder::getFaceVertexNormals(targetMesh, normals, normalIds);
+        RETURN_IF_ERROR(status);
+
+        status = polyReorder::getNormalLocks(targetMesh, normalIds, lockedNormals);
+        RETURN_IF_ERROR(status);
+
+        status = polyReorder::getEdgeSmoothing(targetMesh, edgeSmoothing);
+        RETURN_IF_ERROR(status);
+
+        status = polyReorder::getUVs(targetMesh, uvSets);
+        RETURN_IF_ERROR(status);
+
+        status = polyReorder::getEdgeVertices(targetMesh, edgeVertices);
+        RETURN_IF_ERROR(status);
+    }
+
+    {
+        PhaseScope scope("reorderChannels", statistics);
 
-        for (uint i = 0; i < numVertices; i++)
+        if (componentOrder)
         {
-            floatPoints[i].setCast(points[i]);
+            polyReorder::reorderArray(normalIds, componentOrder->cornerOrder);
+            polyReorder::reorderUVs(uvSets, polyCounts, *componentOrder);
         }
 
-        outMeshFn.createInPlace(
-            numVertices, 
-            numPolys,
-            floatPoints,
-            polyCounts,
-            polyConnects
-        );
+        if (componentOrder && !componentOrder->edgeOrder.empty())
+        {
+            std::vector<int> order(pointOrder.length());
+            pointOrder.get(order.data());
 
-        CHECK_MSTATUS_AND_RETURN_IT(status);
+            polyReorder::reorderEdgeVertices(edgeVertices, order, componentOrder->edgeOrder, orderedEdgeVertices);
+        }
+
+        polyReorder::gatherFaceVertexNormals(normals, normalIds, lockedNormals, vertexNormals, lockedList);
     }
 
-    status = polyReorder::setUVs(outMesh, uvSets);
-    RETURN_IF_ERROR(status);
+    if (!polyReorder::advance(progress, 2))
+    {
+        return MStatus::kFailure;
+    }
 
-    status = polyReorder::setFaceVertexNormals(outMesh, polyCounts, polyConnects, vertexNormals);
-    RETURN_IF_ERROR(status);
+    {
+        PhaseScope scope("createMesh", statistics);
 
-    status = polyReorder::setFaceVertexLocks(outMesh, lockedList);
-    RETURN_IF_ERROR(status);
+        if (isMeshData)
+        {
+            MFnMesh outMeshFn;
+
+            outMeshFn.create(
+                numVertices, 
+                numPolys,
+                points,
+                polyCounts,
+                polyConnects,
+                outMesh,
+                &status
+            );
+
+            CHECK_MSTATUS_AND_RETURN_IT(status);
+        } else {
+            MFnMesh outMeshFn(outMesh);
 
-    status = polyReorder::setEdgeSmoothing(outMesh, edgeSmoothing);
-    RETURN_IF_ERROR(status);
+            status = outMeshFn.createInPlace(
+                numVertices, 
+                numPolys,
+                points,
+                polyCounts,
+                polyConnects
+            );
+
+            CHECK_MSTATUS_AND_RETURN_IT(status);
+        }
+    }
+
+    {
+        PhaseScope scope("writeChannels", statistics);
+
+        status = polyReorder::setUVs(outMesh, uvSets);
+        RETURN_IF_ERROR(status);
+
+        status = polyReorder::setFaceVertexNormals(outMesh, polyCounts, polyConnects, vertexNormals);
+        RETURN_IF_ERROR(status);
+
+        status = polyReorder::setFaceVertexLocks(outMesh, lockedList);
+        RETURN_IF_ERROR(status);
+
+        std::vector<int> outEdgeVertices;
+
+        status = polyReorder::getEdgeVertices(outMesh, outEdgeVertices);
+        RETURN_IF_ERROR(status);
+
+        if (!orderedEdgeVertices.empty() && polyReorder::hasSameEdges(orderedEdgeVertices, outEdgeVertices))
+        {
+            polyReorder::reorderArray(edgeSmoothing, componentOrder->edgeOrder);
+        } else {
+            status = polyReorder::matchEdgeSmoothing(edgeVertices, pointOrder, outEdgeVertices, edgeSmoothing);
+            RETURN_IF_ERROR(status);
+        }
+
+        status = polyReorder::setEdgeSmoothing(outMesh, edgeSmoothing);
+        RETURN_IF_ERROR(status);
+    }
 
     return MStatus::kSuccess;
+}
+
+
+/**
+    Returns true if restoreMesh can give mesh back exactly after a reorder -
+    that is, if it holds nothing a reorder drops (color sets, creases,
+    invisible faces, holes or blind data), and a copy rebuilt from its own
+    faces gets the same edges, so that rebuilding it again after a reorder
+    numbers them the way they were.
+*/
+bool polyReorder::canRestoreMesh(MObject &mesh)
+{
+    MStatus status;
+
+    MFnMesh meshFn(mesh, &status);
+
+    if (!status || meshFn.numColorSets() != 0)
+    {
+        return false;
+    }
+
+    MUintArray creaseIds;
+    MDoubleArray creaseValues;
+
+    meshFn.getCreaseEdges(creaseIds, creaseValues);
+
+    if (creaseIds.length() != 0)
+    {
+        return false;
+    }
+
+    meshFn.getCreaseVertices(creaseIds, creaseValues);
+
+    if (creaseIds.length() != 0)
+    {
+        return false;
+    }
+
+    if (meshFn.getInvisibleFaces().length() != 0)
+    {
+        return false;
+    }
+
+    MIntArray holeInfo;
+    MIntArray holeVertices;
+
+    if (meshFn.getHoles(holeInfo, holeVertices) != 0)
+    {
+        return false;
+    }
+
+    const MFn::Type componentTypes[] = {
+        MFn::kMeshVertComponent,
+        MFn::kMeshEdgeComponent,
+        MFn::kMeshPolygonComponent,
+        MFn::kMeshFaceVertComponent
+    };
+
+    for (MFn::Type componentType : componentTypes)
+    {
+        if (meshFn.hasBlindData(componentType))
+        {
+            return false;
+        }
+    }
+
+    int numVertices;
+    std::vector<int> polyCounts;
+    std::vector<int> polyConnects;
+    std::vector<int> edgeVertices;
+
+    status = polyReorder::getMeshArrays(mesh, numVertices, polyCounts, polyConnects, edgeVertices);
+
+    if (!status) { return false; }
+
+    MFloatPointArray points;
+    MIntArray counts(polyCounts.data(), (uint) polyCounts.size());
+    MIntArray connects(polyConnects.data(), (uint) polyConnects.size());
+
+    status = meshFn.getPoints(points);
+
+    if (!status) { return false; }
+
+    MFnMeshData copyData;
+    MObject copy = copyData.create(&status);
+
+    if (!status) { return false; }
+
+    MFnMesh copyFn;
+    copyFn.create(numVertices, (int) polyCounts.size(), points, counts, connects, copy, &status);
+
+    if (!status) { return false; }
+
+    std::vector<int> copyEdgeVertices;
+
+    status = polyReorder::getEdgeVertices(copy, copyEdgeVertices);
+
+    return status && polyReorder::hasSameEdges(edgeVertices, copyEdgeVertices);
+}
+
+
+/**
+    Undoes reorderMesh on a mesh it rebuilt from its source with pointOrder
+    and componentOrder, by rebuilding it again with the inverse orders. The
+    original faces are read back from the current ones, so nothing but the
+    orders has to be kept.
+*/
+MStatus polyReorder::restoreMesh(MObject &mesh, MIntArray &pointOrder, const ComponentOrder &componentOrder)
+{
+    MStatus status;
+
+    MFnMesh meshFn(mesh, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    MIntArray currentCounts;
+    MIntArray currentConnects;
+
+    status = meshFn.getVertices(currentCounts, currentConnects);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    std::vector<int> counts(currentCounts.length());
+    std::vector<int> connects(currentConnects.length());
+    std::vector<int> order(pointOrder.length());
+
+    currentCounts.get(counts.data());
+    currentConnects.get(connects.data());
+    pointOrder.get(order.data());
+
+    std::vector<int> inverseOrder;
+    std::vector<int> originalCounts;
+    std::vector<int> originalConnects;
+
+    ComponentOrder inverseComponentOrder;
+
+    polyReorder::invertOrder(order, inverseOrder);
+    polyReorder::invertComponentOrder(componentOrder, inverseComponentOrder);
+    polyReorder::restorePolys(counts, connects, inverseOrder, componentOrder, originalCounts, originalConnects);
+
+    inverseComponentOrder.edgeOrder.clear();
+
+    MIntArray inversePointOrder(inverseOrder.data(), (uint) inverseOrder.size());
+    MIntArray polyCounts(originalCounts.data(), (uint) originalCounts.size());
+    MIntArray polyConnects(originalConnects.data(), (uint) originalConnects.size());
+
+    return polyReorder::rebuildMesh(mesh, inversePointOrder, polyCounts, polyConnects, mesh, false, &inverseComponentOrder);
 }
\ No newline at end of file
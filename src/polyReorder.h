@@ -6,19 +6,24 @@
 #ifndef YANTOR3D_POLY_REORDER_H
 #define YANTOR3D_POLY_REORDER_H
 
+#include "componentSelection.h"
 #include "meshData.h"
+#include "meshReorder.h"
+#include "meshTopology.h"
+#include "phaseStatistics.h"
+#include "progress.h"
+#include "topologyFingerprint.h"
 
 #include <cstdint>
 #include <deque>
 #include <vector>
-#include <unordered_map>
 
+#include <maya/MDagPath.h>
 #include <maya/MFloatArray.h>
 #include <maya/MFloatPointArray.h>
 #include <maya/MFloatVectorArray.h>
 #include <maya/MIntArray.h>
 #include <maya/MObject.h>
-#include <maya/MPointArray.h>
 #include <maya/MStatus.h>
 #include <maya/MString.h>
 #include <maya/MVectorArray.h>
@@ -26,15 +31,6 @@
 
 namespace polyReorder
 {
-    struct ComponentSelection
-    {
-        int vertexIndex;
-        int edgeIndex;
-        int faceIndex;
-
-        ComponentSelection() {}
-    };
-
     struct UVSetData
     {
         MIntArray   uvCounts;
@@ -46,33 +42,125 @@ namespace polyReorder
         MString     name;
     };
 
-    inline uint64_t twoIntKey(int id1, int id2) 
-    { 
-        int o1 = id1 <= id2;
-        int o2 = 1 - o1;
+    /**
+        The arrays a MeshKey is hashed from. They are read off the mesh with a
+        few bulk queries and copied into plain vectors, so they can be hashed
+        on any thread.
+    */
+    struct MeshKeyArrays
+    {
+        int                 numVertices = 0;
+        int                 numNormals  = 0;
 
-        uint32_t vtx0 = (id1 * o1) + (id2 * o2);
-        uint32_t vtx1 = (id2 * o1) + (id1 * o2);
+        std::vector<int>    polyCounts;
+        std::vector<int>    polyConnects;
+        std::vector<int>    normalIds;
 
-        return uint64_t(vtx0) | (uint64_t(vtx1) << 32); 
+        /** For each UV set: its UV count, name, per-face UV counts and UV ids. */
+        std::vector<int>    uvAssignments;
     };
 
+    /**
+        Hashes of the faces, normal ids and UV assignments of a mesh - what a
+        reordered mesh is built from other than its points that can be read
+        in bulk. Hard edges split normals, so they show in the normal ids.
+        Two meshes with equal keys reorder into the same faces, UV layout
+        and normal layout.
+    */
+    struct MeshKey
+    {
+        int         numVertices = 0;
+
+        uint64_t    topology    = 0;
+        uint64_t    uvs         = 0;
+        uint64_t    normals     = 0;
+
+        bool        operator==(const MeshKey &other) const
+        {
+            return (
+                   numVertices == other.numVertices
+                && topology == other.topology
+                && uvs == other.uvs
+                && normals == other.normals
+            );
+        }
+    };
+
+    MStatus getEdgeVertices(MObject &mesh, std::vector<int> &edgeVertices);
+    MStatus getMeshArrays(MObject &mesh, int &numVertices, std::vector<int> &polyCounts, std::vector<int> &polyConnects, std::vector<int> &edgeVertices);
+    MStatus getMeshData(MDagPath &mesh, MeshData &meshData, Progress *progress=nullptr);
+    MStatus getMeshTopology(MDagPath &mesh, MeshTopology &meshTopology, Progress *progress=nullptr);
+    MStatus getTopologyFingerprint(MDagPath &mesh, TopologyFingerprint &fingerprint, int numberOfThreads=1);
+
+    bool    hasSameTopology(MDagPath &a, MDagPath &b, int numberOfThreads=1);
+    bool    hasSameTopology(const TopologyFingerprint &a, MDagPath &b, int numberOfThreads=1);
+
     void    getFaceVertexList(MIntArray &polyCounts, MIntArray &polyConnects, MIntArray &faceList, MIntArray &vertexList);
 
-    MStatus getPoints(MObject &mesh, MIntArray &pointOrder, MPointArray &outPoints);
+    MStatus getPoints(MObject &mesh, MIntArray &pointOrder, MFloatPointArray &outPoints, int numberOfThreads=0);
+    MStatus getPoints(MObject &mesh, const std::vector<int> &pointOrder, MFloatPointArray &outPoints, int numberOfThreads=0);
+    bool    hasSameFaces(MObject &mesh, MIntArray &polyCounts, MIntArray &polyConnects, const ComponentOrder *componentOrder);
+    MStatus setPointsOnly(MObject &targetMesh, MFloatPointArray &points, MObject &outMesh, bool isMeshData);
     MStatus getPolys(MObject &mesh, MIntArray &pointOrder, MIntArray &polyCounts, MIntArray &polyConnects, bool reorderPoints);
-    MStatus getFaceVertexNormals(MObject &mesh, MVectorArray &vertexNormals);
+    MStatus getFaceVertexNormals(MObject &mesh, MFloatVectorArray &normals, MIntArray &normalIds);
     MStatus setFaceVertexNormals(MObject &mesh, MIntArray &polyCounts, MIntArray &polyConnects, MVectorArray &vertexNormals);
-    MStatus getFaceVertexLocks(MObject &mesh, MIntArray &lockedList);
+    MStatus getNormalLocks(MObject &mesh, MIntArray &normalIds, MIntArray &lockedNormals);
     MStatus setFaceVertexLocks(MObject &mesh, MIntArray &lockedList);
 
-    MStatus getEdgeSmoothing(MObject &mesh, MIntArray &pointOrder, std::unordered_map<uint64_t, bool> &edgeSmoothing);
-    MStatus setEdgeSmoothing(MObject &mesh, std::unordered_map<uint64_t, bool> &edgeSmoothing);
+    void    gatherFaceVertexNormals(
+                MFloatVectorArray &normals, 
+                MIntArray &normalIds, 
+                MIntArray &lockedNormals, 
+                MVectorArray &vertexNormals, 
+                MIntArray &lockedList
+            );
+
+    MStatus getEdgeSmoothing(MObject &mesh, MIntArray &edgeSmoothing);
+    MStatus setEdgeSmoothing(MObject &mesh, MIntArray &edgeSmoothing);
+    MStatus matchEdgeSmoothing(
+                const std::vector<int> &edgeVertices, 
+                MIntArray &pointOrder, 
+                const std::vector<int> &outEdgeVertices, 
+                MIntArray &edgeSmoothing
+            );
+
+    MStatus getMeshKey(MObject &mesh, MeshKey &key, int numberOfThreads=1);
+    MStatus getMeshKeyArrays(MObject &mesh, MeshKeyArrays &arrays);
+    MeshKey getMeshKey(const MeshKeyArrays &arrays, int numberOfThreads=1);
+    uint64_t hashArray(const MIntArray &values, uint64_t seed=0, int numberOfThreads=1);
+    uint64_t hashArray(const MFloatArray &values, uint64_t seed=0, int numberOfThreads=1);
 
     MStatus getUVs(MObject &mesh, std::vector<UVSetData> &uvSets);
     MStatus setUVs(MObject &mesh, std::vector<UVSetData> &uvSets);
+
+    void    reorderArray(MIntArray &values, const std::vector<int> &order);
+    void    reorderUVs(std::vector<UVSetData> &uvSets, MIntArray &polyCounts, const ComponentOrder &componentOrder);
     
-    MStatus reorderMesh(MObject &sourceMesh, MObject &targetMesh, MIntArray &pointOrder, MObject &outMesh, bool isMeshData=false);
+    MStatus reorderMesh(
+                MObject &sourceMesh, 
+                MObject &targetMesh, 
+                MIntArray &pointOrder, 
+                MObject &outMesh, 
+                bool isMeshData=false, 
+                const ComponentOrder *componentOrder=nullptr,
+                PhaseStatistics *statistics=nullptr,
+                Progress *progress=nullptr
+            );
+
+    MStatus rebuildMesh(
+                MObject &targetMesh, 
+                MIntArray &pointOrder, 
+                MIntArray &polyCounts, 
+                MIntArray &polyConnects, 
+                MObject &outMesh, 
+                bool isMeshData=false, 
+                const ComponentOrder *componentOrder=nullptr,
+                PhaseStatistics *statistics=nullptr,
+                Progress *progress=nullptr
+            );
+
+    bool    canRestoreMesh(MObject &mesh);
+    MStatus restoreMesh(MObject &mesh, MIntArray &pointOrder, const ComponentOrder &componentOrder);
 }
 
 #endif
\ No newline at end of file
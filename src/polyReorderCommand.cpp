@@ -3,11 +3,23 @@
     You may use, distribute, or modify this code under the terms of the MIT license.
 */
 
+#include "computationProgress.h"
+#include "correspondence.h"
+#include "meshReorder.h"
 #include "meshTopology.h"
+#include "parallel.h"
 #include "parseArgs.h"
+#include "phaseStatistics.h"
+#include "pointOrderCodec.h"
+#include "pointOrderData.h"
 #include "polyReorder.h"
 #include "polyReorderCommand.h"
 #include "polyReorderNode.h"
+#include "progress.h"
+
+#include <chrono>
+#include <utility>
+#include <vector>
 
 #include <maya/MArgDatabase.h>
 #include <maya/MArgList.h>
@@ -16,9 +28,10 @@
 #include <maya/MDagModifier.h>
 #include <maya/MFn.h>
 #include <maya/MFnDagNode.h>
-#include <maya/MFnIntArrayData.h>
 #include <maya/MFnMesh.h>
 #include <maya/MFnMeshData.h>
+#include <maya/MFnPluginData.h>
+#include <maya/MStringArray.h>
 #include <maya/MGlobal.h>
 #include <maya/MObject.h>
 #include <maya/MPlug.h>
@@ -31,6 +44,24 @@
 #define RETURN_IF_ERROR(s) if (!s) { return s; }
 
 
+namespace
+{
+    /**
+        Points a command's progress at a Progress for as long as it lives, so
+        redo and undo never see one that has gone.
+    */
+    class ProgressGuard
+    {
+    public:
+                        ProgressGuard(Progress *&target, Progress *progress) : target(target) { target = progress; }
+                        ~ProgressGuard() { target = nullptr; }
+
+    private:
+        Progress        *&target;
+    };
+}
+
+
 PolyReorderCommand::PolyReorderCommand() {}
 
 
@@ -70,8 +101,17 @@ MSyntax PolyReorderCommand::getSyntax()
     syntax.addFlag(SOURCE_MESH_FLAG, SOURCE_MESH_LONG_FLAG, MSyntax::kString);
     syntax.addFlag(DESTINATION_MESH_FLAG, DESTINATION_MESH_LONG_FLAG, MSyntax::kString);
 
+    syntax.makeFlagMultiUse(DESTINATION_MESH_FLAG);
+
     syntax.addFlag(REPLACE_ORIGINAL_FLAG, REPLACE_ORIGINAL_LONG_FLAG, MSyntax::kBoolean);
     syntax.addFlag(CONSTUCTION_HISTORY_FLAG, CONSTUCTION_HISTORY_LONG_FLAG, MSyntax::kBoolean);
+    syntax.addFlag(AUTO_MATCH_FLAG, AUTO_MATCH_LONG_FLAG, MSyntax::kBoolean);
+    syntax.addFlag(NUMBER_OF_THREADS_FLAG, NUMBER_OF_THREADS_LONG_FLAG, MSyntax::kLong);
+    syntax.addFlag(CHECK_ORDER_FLAG, CHECK_ORDER_LONG_FLAG, MSyntax::kBoolean);
+    syntax.addFlag(QUERY_ORDER_FLAG, QUERY_ORDER_LONG_FLAG, MSyntax::kBoolean);
+    syntax.addFlag(EXPORT_ORDER_FLAG, EXPORT_ORDER_LONG_FLAG, MSyntax::kString);
+    syntax.addFlag(IMPORT_ORDER_FLAG, IMPORT_ORDER_LONG_FLAG, MSyntax::kString);
+    syntax.addFlag(STATISTICS_FLAG, STATISTICS_LONG_FLAG, MSyntax::kBoolean);
 
     return syntax;
 }
@@ -81,17 +121,28 @@ MStatus PolyReorderCommand::parseArguments(MArgDatabase &argsData)
 {
     MStatus status;
 
-    status = parseArgs::getDagPathArgument(argsData, SOURCE_MESH_FLAG, this->sourceMesh, true);
+    status = parseArgs::getStringArgument(argsData, IMPORT_ORDER_FLAG, this->importOrderPath);
     RETURN_IF_ERROR(status);
 
-    status = parseArgs::getDagPathArgument(argsData, DESTINATION_MESH_FLAG, this->destinationMesh, true);
+    bool isImporting = this->importOrderPath.length() != 0;
+
+    status = parseArgs::getDagPathArgument(argsData, SOURCE_MESH_FLAG, this->sourceMesh, !isImporting);
     RETURN_IF_ERROR(status);
 
     status = parseComponentArguments(argsData, SOURCE_COMPONENTS_FLAG, this->sourceMesh, sourceComponents);
     RETURN_IF_ERROR(status);
 
-    status = parseComponentArguments(argsData, DESTINATION_COMPONENTS_FLAG, this->destinationMesh, destinationComponents);
-    RETURN_IF_ERROR(status);
+    if (argsData.numberOfFlagUses(DESTINATION_MESH_FLAG) > 1)
+    {
+        status = parseBatchArguments(argsData);
+        RETURN_IF_ERROR(status);
+    } else {
+        status = parseArgs::getDagPathArgument(argsData, DESTINATION_MESH_FLAG, this->destinationMesh, true);
+        RETURN_IF_ERROR(status);
+
+        status = parseComponentArguments(argsData, DESTINATION_COMPONENTS_FLAG, this->destinationMesh, destinationComponents);
+        RETURN_IF_ERROR(status);
+    }
 
     status = parseArgs::getBooleanArgument(argsData, CONSTUCTION_HISTORY_FLAG, this->constructionHistory, true);
     RETURN_IF_ERROR(status);
@@ -99,6 +150,29 @@ MStatus PolyReorderCommand::parseArguments(MArgDatabase &argsData)
     status = parseArgs::getBooleanArgument(argsData, REPLACE_ORIGINAL_FLAG, this->replaceOriginal, true);
     RETURN_IF_ERROR(status);
 
+    status = parseArgs::getBooleanArgument(argsData, AUTO_MATCH_FLAG, this->autoMatch, false);
+    RETURN_IF_ERROR(status);
+
+    status = parseArgs::getIntArgument(argsData, NUMBER_OF_THREADS_FLAG, this->numberOfThreads, 0);
+    RETURN_IF_ERROR(status);
+
+    status = parseArgs::getBooleanArgument(argsData, CHECK_ORDER_FLAG, this->checkOrderOnly, false);
+    RETURN_IF_ERROR(status);
+
+    status = parseArgs::getBooleanArgument(argsData, QUERY_ORDER_FLAG, this->queryOrderOnly, false);
+    RETURN_IF_ERROR(status);
+
+    status = parseArgs::getStringArgument(argsData, EXPORT_ORDER_FLAG, this->exportOrderPath);
+    RETURN_IF_ERROR(status);
+
+    if (this->exportOrderPath.length() != 0)
+    {
+        this->queryOrderOnly = true;
+    }
+
+    status = parseArgs::getBooleanArgument(argsData, STATISTICS_FLAG, this->showStatistics, false);
+    RETURN_IF_ERROR(status);
+
     return status;
 }
 
@@ -148,11 +222,13 @@ MStatus PolyReorderCommand::validateArguments()
     int numDestinationEdges = (int) destinationMeshFn.numEdges();
     int numDestinationPolys = (int) destinationMeshFn.numPolygons();
 
-    bool vertCountMatch = numSourceVertices == numDestinationVertices;
-    bool edgeCountMatch = numSourceEdges == numDestinationEdges;
-    bool polyCountMatch = numSourcePolys == numDestinationPolys;
+    bool topologyMatches = checkOrderOnly;
 
-    bool topologyMatches = vertCountMatch && edgeCountMatch && polyCountMatch;
+    if (!topologyMatches)
+    {
+        PhaseScope scope("compareTopology", &this->statistics);
+        topologyMatches = polyReorder::hasSameTopology(sourceMesh, destinationMesh, numberOfThreads);
+    }
 
     if (!topologyMatches)
     {
@@ -166,45 +242,72 @@ MStatus PolyReorderCommand::validateArguments()
     int numSourceComponents = (int) sourceComponents.size();
     int numDestinationComponents = (int) destinationComponents.size();
 
-    if (numSourceComponents == 0)
+    if (autoMatch)
     {
-        MString errorMessage("^1s/^2s flag(s) are required.");
-        errorMessage.format(errorMessage, MString(SOURCE_COMPONENTS_LONG_FLAG), MString(SOURCE_COMPONENTS_FLAG));
+        if (numDestinationComponents != 0)
+        {
+            MString errorMessage("^1s/^2s cannot be used with ^3s/^4s.");
+            errorMessage.format(
+                errorMessage,
+                MString(DESTINATION_COMPONENTS_LONG_FLAG), 
+                MString(DESTINATION_COMPONENTS_FLAG),
+                MString(AUTO_MATCH_LONG_FLAG),
+                MString(AUTO_MATCH_FLAG)
+            );
+
+            this->displayError(errorMessage);
+            return MStatus::kFailure;
+        }
+    } else {
+        if (numSourceComponents == 0)
+        {
+            MString errorMessage("^1s/^2s flag(s) are required.");
+            errorMessage.format(errorMessage, MString(SOURCE_COMPONENTS_LONG_FLAG), MString(SOURCE_COMPONENTS_FLAG));
 
-        this->displayError(errorMessage);
-        return MStatus::kFailure;
+            this->displayError(errorMessage);
+            return MStatus::kFailure;
+        }
+
+        if (numDestinationComponents == 0)
+        {
+            MString errorMessage("^1s/^2s flag(s) are required.");
+            errorMessage.format(errorMessage, MString(DESTINATION_COMPONENTS_LONG_FLAG), MString(DESTINATION_COMPONENTS_FLAG));
+
+            this->displayError(errorMessage);
+            return MStatus::kFailure;
+        }
+
+        if (numSourceComponents != numDestinationComponents)
+        {
+            MString errorMessage("Must pass the same number of ^1s/^2s and ^3s/^4s flags.");
+            errorMessage.format(
+                errorMessage,
+                MString(SOURCE_COMPONENTS_LONG_FLAG), 
+                MString(SOURCE_COMPONENTS_FLAG),
+                MString(DESTINATION_COMPONENTS_LONG_FLAG),
+                MString(DESTINATION_COMPONENTS_FLAG)
+            );
+
+            this->displayError(errorMessage);
+            return MStatus::kFailure;
+        }
     }
 
-    if (numDestinationComponents == 0)
+    MeshData sourceMeshData;
+    MeshData destinationMeshData;
+
     {
-        MString errorMessage("^1s/^2s flag(s) are required.");
-        errorMessage.format(errorMessage, MString(DESTINATION_COMPONENTS_LONG_FLAG), MString(DESTINATION_COMPONENTS_FLAG));
+        PhaseScope scope("validateComponents", &this->statistics);
 
-        this->displayError(errorMessage);
-        return MStatus::kFailure;
+        polyReorder::getMeshData(sourceMesh, sourceMeshData, this->progress);
+        polyReorder::getMeshData(destinationMesh, destinationMeshData, this->progress);
     }
 
-    if (numSourceComponents != numDestinationComponents)
+    if (polyReorder::isCancelled(this->progress))
     {
-        MString errorMessage("Must pass the same number of ^1s/^2s and ^3s/^4s flags.");
-        errorMessage.format(
-            errorMessage,
-            MString(SOURCE_COMPONENTS_LONG_FLAG), 
-            MString(SOURCE_COMPONENTS_FLAG),
-            MString(DESTINATION_COMPONENTS_LONG_FLAG),
-            MString(DESTINATION_COMPONENTS_FLAG)
-        );
-
-        this->displayError(errorMessage);
         return MStatus::kFailure;
     }
 
-    MeshData sourceMeshData;
-    MeshData destinationMeshData;
-
-    sourceMeshData.unpackMesh(sourceMesh);
-    destinationMeshData.unpackMesh(destinationMesh);
-
     for (polyReorder::ComponentSelection &cs : sourceComponents)
     {
         if (
@@ -216,8 +319,8 @@ MStatus PolyReorderCommand::validateArguments()
             return MStatus::kFailure;
         }
 
-        bool edgeOnFace = contains(sourceMeshData.faceData[cs.faceIndex].connectedEdges, cs.edgeIndex);
-        bool vertexOnEdge = contains(sourceMeshData.edgeData[cs.edgeIndex].connectedVertices, cs.vertexIndex);
+        bool edgeOnFace = contains(sourceMeshData.faceEdges(cs.faceIndex), cs.edgeIndex);
+        bool vertexOnEdge = contains(sourceMeshData.edgeVertices(cs.edgeIndex), cs.vertexIndex);
 
         if (!edgeOnFace || !vertexOnEdge)
         {
@@ -237,8 +340,8 @@ MStatus PolyReorderCommand::validateArguments()
             return MStatus::kFailure;
         }
 
-        bool edgeOnFace = contains(destinationMeshData.faceData[cs.faceIndex].connectedEdges, cs.edgeIndex);
-        bool vertexOnEdge = contains(destinationMeshData.edgeData[cs.edgeIndex].connectedVertices, cs.vertexIndex);
+        bool edgeOnFace = contains(destinationMeshData.faceEdges(cs.faceIndex), cs.edgeIndex);
+        bool vertexOnEdge = contains(destinationMeshData.edgeVertices(cs.edgeIndex), cs.vertexIndex);
 
         if (!edgeOnFace || !vertexOnEdge)
         {
@@ -252,6 +355,309 @@ MStatus PolyReorderCommand::validateArguments()
 }
 
 
+/**
+    With more than one destination mesh every -destinationComponents flag
+    must name its mesh, and goes to the destination whose edge, face and
+    vertex it selects.
+*/
+MStatus PolyReorderCommand::parseBatchArguments(MArgDatabase &argsData)
+{
+    MStatus status;
+
+    std::vector<MDagPath> destinationMeshes;
+
+    status = parseArgs::getDagPathArguments(argsData, DESTINATION_MESH_FLAG, destinationMeshes);
+    RETURN_IF_ERROR(status);
+
+    this->batch.resize(destinationMeshes.size());
+
+    for (size_t i = 0; i < destinationMeshes.size(); i++)
+    {
+        this->batch[i].mesh = destinationMeshes[i];
+    }
+
+    uint numComponents = argsData.numberOfFlagUses(DESTINATION_COMPONENTS_FLAG);
+
+    for (uint i = 0; i < numComponents; i++)
+    {
+        MArgList args;
+        MSelectionList selection;
+
+        status = argsData.getFlagArgumentList(DESTINATION_COMPONENTS_FLAG, i, args);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        for (uint argIndex = 0; argIndex < args.length(); argIndex++)
+        {
+            MString obj = args.asString(argIndex, &status);
+            CHECK_MSTATUS_AND_RETURN_IT(status);
+
+            if (obj.index('.') == -1)
+            {
+                MString errorMessage("^1s/^2s must name the mesh of each component when more than one ^3s/^4s is given.");
+                errorMessage.format(
+                    errorMessage,
+                    MString(DESTINATION_COMPONENTS_LONG_FLAG),
+                    MString(DESTINATION_COMPONENTS_FLAG),
+                    MString(DESTINATION_MESH_LONG_FLAG),
+                    MString(DESTINATION_MESH_FLAG)
+                );
+
+                this->displayError(errorMessage);
+                return MStatus::kFailure;
+            }
+
+            status = selection.add(obj);
+
+            if (!status)
+            {
+                MGlobal::displayError("No object matches name: " + obj);
+                return status;
+            }
+        }
+
+        bool isAssigned = false;
+
+        for (polyReorder::BatchDestination &destination : this->batch)
+        {
+            MObject edge;
+            MObject face;
+            MObject vertex;
+
+            MStatus edgeStatus = parseArgs::getComponentArgument(selection, MFn::Type::kMeshEdgeComponent, destination.mesh, edge);
+            MStatus faceStatus = parseArgs::getComponentArgument(selection, MFn::Type::kMeshPolygonComponent, destination.mesh, face);
+            MStatus vertexStatus = parseArgs::getComponentArgument(selection, MFn::Type::kMeshVertComponent, destination.mesh, vertex);
+
+            if (!edgeStatus || !faceStatus || !vertexStatus)
+            {
+                continue;
+            }
+
+            polyReorder::ComponentSelection cs;
+            cs.edgeIndex   = parseArgs::getComponentIndex(edge);
+            cs.faceIndex   = parseArgs::getComponentIndex(face);
+            cs.vertexIndex = parseArgs::getComponentIndex(vertex);
+
+            destination.components.push_back(cs);
+
+            isAssigned = true;
+            break;
+        }
+
+        if (!isAssigned)
+        {
+            MString errorMessage("Each ^1s/^2s flag must select an edge, a face and a vertex on one of the ^3s/^4s meshes.");
+            errorMessage.format(
+                errorMessage,
+                MString(DESTINATION_COMPONENTS_LONG_FLAG),
+                MString(DESTINATION_COMPONENTS_FLAG),
+                MString(DESTINATION_MESH_LONG_FLAG),
+                MString(DESTINATION_MESH_FLAG)
+            );
+
+            this->displayError(errorMessage);
+            return MStatus::kFailure;
+        }
+    }
+
+    return MStatus::kSuccess;
+}
+
+
+/**
+    The batch counterpart of validateArguments. The source is fingerprinted
+    once for all the destinations, and the components are checked once the
+    meshes have been read, in getBatchPointOrders.
+*/
+MStatus PolyReorderCommand::validateBatchArguments()
+{
+    if (this->checkOrderOnly || this->queryOrderOnly)
+    {
+        MString errorMessage("^1s, ^2s and ^3s cannot be used with more than one ^4s.");
+        errorMessage.format(
+            errorMessage,
+            MString(CHECK_ORDER_LONG_FLAG),
+            MString(QUERY_ORDER_LONG_FLAG),
+            MString(EXPORT_ORDER_LONG_FLAG),
+            MString(DESTINATION_MESH_LONG_FLAG)
+        );
+
+        this->displayError(errorMessage);
+        return MStatus::kFailure;
+    }
+
+    if (!parseArgs::isNodeType(this->sourceMesh, MFn::kMesh))
+    {
+        MString errorMessage("^1s/^2s expects a mesh.");
+        errorMessage.format(errorMessage, MString(SOURCE_MESH_LONG_FLAG), MString(SOURCE_MESH_FLAG));
+
+        this->displayError(errorMessage);
+        return MStatus::kFailure;
+    }
+
+    parseArgs::extendToShape(this->sourceMesh);
+
+    int numSourceComponents = (int) sourceComponents.size();
+
+    if (!autoMatch && numSourceComponents == 0)
+    {
+        MString errorMessage("^1s/^2s flag(s) are required.");
+        errorMessage.format(errorMessage, MString(SOURCE_COMPONENTS_LONG_FLAG), MString(SOURCE_COMPONENTS_FLAG));
+
+        this->displayError(errorMessage);
+        return MStatus::kFailure;
+    }
+
+    polyReorder::TopologyFingerprint sourceFingerprint;
+
+    MStatus status = polyReorder::getTopologyFingerprint(this->sourceMesh, sourceFingerprint, this->numberOfThreads);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    for (size_t i = 0; i < this->batch.size(); i++)
+    {
+        polyReorder::BatchDestination &destination = this->batch[i];
+
+        if (!parseArgs::isNodeType(destination.mesh, MFn::kMesh))
+        {
+            MString errorMessage("^1s/^2s expects a mesh.");
+            errorMessage.format(errorMessage, MString(DESTINATION_MESH_LONG_FLAG), MString(DESTINATION_MESH_FLAG));
+
+            this->displayError(errorMessage);
+            return MStatus::kFailure;
+        }
+
+        parseArgs::extendToShape(destination.mesh);
+
+        if (destination.mesh == this->sourceMesh)
+        {
+            MString errorMessage("Must specify difference meshes for ^1s and ^2s flags.");
+            errorMessage.format(errorMessage, MString(SOURCE_MESH_LONG_FLAG), MString(DESTINATION_MESH_LONG_FLAG));
+
+            this->displayError(errorMessage);
+            return MStatus::kFailure;
+        }
+
+        for (size_t j = 0; j < i; j++)
+        {
+            if (destination.mesh == this->batch[j].mesh)
+            {
+                MString errorMessage("^1s is passed to ^2s more than once.");
+                errorMessage.format(errorMessage, destination.mesh.partialPathName(), MString(DESTINATION_MESH_LONG_FLAG));
+
+                this->displayError(errorMessage);
+                return MStatus::kFailure;
+            }
+        }
+
+        if (!polyReorder::hasSameTopology(sourceFingerprint, destination.mesh, this->numberOfThreads))
+        {
+            MString errorMessage("^1s does not have the same topology as ^2s.");
+            errorMessage.format(errorMessage, destination.mesh.partialPathName(), this->sourceMesh.partialPathName());
+
+            this->displayError(errorMessage);
+            return MStatus::kFailure;
+        }
+
+        int numDestinationComponents = (int) destination.components.size();
+
+        if (autoMatch && numDestinationComponents != 0)
+        {
+            MString errorMessage("^1s/^2s cannot be used with ^3s/^4s.");
+            errorMessage.format(
+                errorMessage,
+                MString(DESTINATION_COMPONENTS_LONG_FLAG), 
+                MString(DESTINATION_COMPONENTS_FLAG),
+                MString(AUTO_MATCH_LONG_FLAG),
+                MString(AUTO_MATCH_FLAG)
+            );
+
+            this->displayError(errorMessage);
+            return MStatus::kFailure;
+        }
+
+        if (!autoMatch && numDestinationComponents != numSourceComponents)
+        {
+            MString errorMessage("Must pass as many ^1s flags for ^2s as there are ^3s flags.");
+            errorMessage.format(
+                errorMessage,
+                MString(DESTINATION_COMPONENTS_LONG_FLAG),
+                destination.mesh.partialPathName(),
+                MString(SOURCE_COMPONENTS_LONG_FLAG)
+            );
+
+            this->displayError(errorMessage);
+            return MStatus::kFailure;
+        }
+    }
+
+    return MStatus::kSuccess;
+}
+
+
+/**
+    Reads the order to apply from importOrderPath and checks it fits the
+    destination mesh. Nothing else is read off either mesh - the order is
+    applied as it is.
+*/
+MStatus PolyReorderCommand::validateImportArguments()
+{
+    bool hasOtherModes = (
+           !this->batch.empty()
+        || !this->sourceComponents.empty()
+        || !this->destinationComponents.empty()
+        || this->autoMatch
+        || this->checkOrderOnly
+        || this->queryOrderOnly
+    );
+
+    if (hasOtherModes)
+    {
+        MString errorMessage("^1s/^2s only takes one ^3s and cannot be used with the component, match, check or query flags.");
+        errorMessage.format(
+            errorMessage,
+            MString(IMPORT_ORDER_LONG_FLAG),
+            MString(IMPORT_ORDER_FLAG),
+            MString(DESTINATION_MESH_LONG_FLAG)
+        );
+
+        this->displayError(errorMessage);
+        return MStatus::kFailure;
+    }
+
+    if (!parseArgs::isNodeType(this->destinationMesh, MFn::kMesh))
+    {
+        MString errorMessage("^1s/^2s expects a mesh.");
+        errorMessage.format(errorMessage, MString(DESTINATION_MESH_LONG_FLAG), MString(DESTINATION_MESH_FLAG));
+
+        this->displayError(errorMessage);
+        return MStatus::kFailure;
+    }
+
+    parseArgs::extendToShape(this->destinationMesh);
+
+    if (!polyReorder::readPointOrderFile(this->importOrderPath.asChar(), this->importedPointOrder))
+    {
+        MString errorMessage("polyReorder failed - could not read a point order from ^1s.");
+        errorMessage.format(errorMessage, this->importOrderPath);
+
+        this->displayError(errorMessage);
+        return MStatus::kFailure;
+    }
+
+    MFnMesh destinationMeshFn(this->destinationMesh);
+
+    if (!polyReorder::isPermutation(this->importedPointOrder, (int) destinationMeshFn.numVertices()))
+    {
+        MString errorMessage("polyReorder failed - the point order in ^1s does not fit ^2s.");
+        errorMessage.format(errorMessage, this->importOrderPath, this->destinationMesh.partialPathName());
+
+        this->displayError(errorMessage);
+        return MStatus::kFailure;
+    }
+
+    return MStatus::kSuccess;
+}
+
+
 MStatus PolyReorderCommand::parseComponentArguments(
     MArgDatabase &argsData,
     const char* flag,
@@ -315,34 +721,260 @@ MStatus PolyReorderCommand::parseComponentArguments(
 }
 
 
-MStatus PolyReorderCommand::doIt(const MArgList& argList)
+MStatus PolyReorderCommand::doIt(const MArgList& argList)
+{
+    MStatus status;
+
+    MArgDatabase argsData(syntax(), argList, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    ComputationProgress monitor;
+    Progress progress(&monitor);
+    ProgressGuard progressGuard(this->progress, &progress);
+
+    this->statistics.clear();
+
+    {
+        PhaseScope scope("parseArguments", &this->statistics);
+
+        status = this->parseArguments(argsData);        
+        RETURN_IF_ERROR(status);
+    }
+
+    if (this->importOrderPath.length() != 0)
+    {
+        PhaseScope scope("validateArguments", &this->statistics);
+
+        status = this->validateImportArguments();
+        RETURN_IF_ERROR(status);
+    } else if (this->batch.empty()) {
+        PhaseScope scope("validateArguments", &this->statistics);
+
+        status = this->validateArguments();
+        RETURN_IF_ERROR(status);
+    } else {
+        {
+            PhaseScope scope("validateArguments", &this->statistics);
+
+            status = this->validateBatchArguments();
+            RETURN_IF_ERROR(status);
+        }
+
+        status = this->getBatchPointOrders();
+        RETURN_IF_ERROR(status);
+    }
+
+    if (this->checkOrderOnly)
+    {
+        return this->checkOrder();
+    }
+
+    if (this->queryOrderOnly)
+    {
+        return this->queryOrder();
+    }
+
+    status = this->redoIt();
+    RETURN_IF_ERROR(status);
+
+    if (this->showStatistics)
+    {
+        MStringArray result;
+        this->statistics.getResult(result);
+
+        this->clearResult();
+        this->setResult(result);
+    }
+
+    return status;
+}
+
+
+MStatus PolyReorderCommand::redoIt()
+{
+    MStatus status;
+
+    if (!this->batch.empty())
+    {
+        return this->redoBatch();
+    }
+
+    if (this->cachedPointOrder.length() == 0)
+    {
+        this->cachedPointOrder = getPointOrder(&status);
+    }
+
+    if (this->cachedPointOrder.length() == 0) { status = MStatus::kFailure; }
+
+    RETURN_IF_ERROR(status);
+
+    MString resultName;
+
+    status = this->applyPointOrder(this->cachedPointOrder, resultName);
+    RETURN_IF_ERROR(status);
+
+    this->appendToResult(resultName);
+
+    if (!this->orderUnchanged && !undoCreatedNode.isNull())
+    {
+        this->appendToResult(MFnDependencyNode(undoCreatedNode).name());
+    }
+
+    return status;
+}
+
+
+/**
+    Applies every destination's order, in the order the meshes were given.
+    The result holds each mesh, or the mesh created for it, followed by the
+    milliseconds spent on it. If one destination fails, those before it are
+    undone again.
+*/
+MStatus PolyReorderCommand::redoBatch()
+{
+    MStatus status;
+
+    this->clearResult();
+
+    for (size_t i = 0; i < this->batch.size(); i++)
+    {
+        polyReorder::BatchDestination &destination = this->batch[i];
+
+        destination.undoOriginalMesh = MObject::kNullObj;
+        destination.undoCreatedNode = MObject::kNullObj;
+        destination.undoCreatedMesh = MObject::kNullObj;
+
+        this->loadDestination(destination);
+
+        MString resultName;
+
+        auto start = std::chrono::steady_clock::now();
+
+        status = this->applyPointOrder(destination.pointOrder, resultName);
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        this->storeDestination(destination);
+
+        if (!status)
+        {
+            if (!polyReorder::isCancelled(this->progress))
+            {
+                MString errorMessage("polyReorder failed - could not reorder ^1s.");
+                errorMessage.format(errorMessage, destination.mesh.partialPathName());
+                MGlobal::displayError(errorMessage);
+            }
+
+            this->undoBatch(i);
+            return status;
+        }
+
+        MString milliseconds;
+        milliseconds += destination.milliseconds + elapsed.count();
+
+        this->appendToResult(resultName);
+        this->appendToResult(milliseconds);
+    }
+
+    return MStatus::kSuccess;
+}
+
+
+/**
+    Undoes the first numberApplied destinations, last one first.
+*/
+MStatus PolyReorderCommand::undoBatch(size_t numberApplied)
+{
+    MStatus status;
+
+    for (size_t i = numberApplied; i > 0; i--)
+    {
+        polyReorder::BatchDestination &destination = this->batch[i - 1];
+
+        this->loadDestination(destination);
+
+        status = this->undoDestination(destination.pointOrder);
+
+        this->storeDestination(destination);
+
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+    }
+
+    return MStatus::kSuccess;
+}
+
+
+/**
+    Makes destination the one the single mesh members refer to, so the
+    single mesh code can apply or undo it. The component order is swapped
+    in rather than copied; storeDestination swaps it back.
+*/
+void PolyReorderCommand::loadDestination(polyReorder::BatchDestination &destination)
 {
-    MStatus status;
+    this->destinationMesh = destination.mesh;
+    this->orderUnchanged = destination.orderUnchanged;
 
-    MArgDatabase argsData(syntax(), argList, &status);
-    CHECK_MSTATUS_AND_RETURN_IT(status);
+    this->undoOriginalMesh = destination.undoOriginalMesh;
+    this->undoCreatedNode = destination.undoCreatedNode;
+    this->undoCreatedMesh = destination.undoCreatedMesh;
 
-    status = this->parseArguments(argsData);        
-    RETURN_IF_ERROR(status);
+    std::swap(this->componentOrder, destination.componentOrder);
+}
 
-    status = this->validateArguments();
-    RETURN_IF_ERROR(status);
 
-    status = this->redoIt();
+void PolyReorderCommand::storeDestination(polyReorder::BatchDestination &destination)
+{
+    destination.orderUnchanged = this->orderUnchanged;
 
-    return status;
+    destination.undoOriginalMesh = this->undoOriginalMesh;
+    destination.undoCreatedNode = this->undoCreatedNode;
+    destination.undoCreatedMesh = this->undoCreatedMesh;
+
+    std::swap(this->componentOrder, destination.componentOrder);
 }
 
 
-MStatus PolyReorderCommand::redoIt()
+/**
+    Reorders destinationMesh to pointOrder and componentOrder, in place or
+    on a copy and with or without a polyReorder node, and sets resultName to
+    the mesh that holds the result.
+
+    If the user interrupts, reorderMesh has stopped before writing anything,
+    so the destination is as it was and only a copy made for it is deleted.
+    Any other failure is handled the same way, except that a destination it
+    has already rebuilt in place is first put back by restoreOriginalMesh -
+    without a saved copy, that is only when its faces have changed, since
+    only a failure after createInPlace can have touched them.
+*/
+MStatus PolyReorderCommand::applyPointOrder(MIntArray &pointOrder, MString &resultName)
 {
     MStatus status;
 
-    MIntArray pointOrder = getPointOrder(&status);
+    std::vector<int> order(pointOrder.length());
+    pointOrder.get(order.data());
 
-    if (pointOrder.length() == 0) { status = MStatus::kFailure; }
+    this->orderUnchanged = (
+           replaceOriginal
+        && polyReorder::isIdentityOrder(order)
+        && polyReorder::isIdentityOrder(componentOrder.faceOrder)
+        && polyReorder::isIdentityOrder(componentOrder.edgeOrder)
+        && polyReorder::isIdentityOrder(componentOrder.cornerOrder)
+    );
 
-    RETURN_IF_ERROR(status);
+    if (this->orderUnchanged)
+    {
+        MDagPath oldMesh(destinationMesh);
+
+        if (oldMesh.node().hasFn(MFn::kMesh))
+        {
+            oldMesh.pop();
+        }
+
+        MGlobal::displayInfo("polyReorder - the meshes are already in the same order, nothing to do.");
+        resultName = oldMesh.partialPathName();
+
+        return MStatus::kSuccess;
+    }
 
     MFnDependencyNode destinationFn(destinationMesh.node());
     MPlug inMeshPlug = destinationFn.findPlug("inMesh");
@@ -366,24 +998,85 @@ MStatus PolyReorderCommand::redoIt()
         }
     }
 
-    if (shouldCreateMesh) { createNewMesh(); }
-    if (shouldCreateNode) { createPolyReorderNode(pointOrder); }
+    if (shouldCreateMesh) 
+    { 
+        PhaseScope scope("createNewMesh", &this->statistics);
+        createNewMesh(); 
+    }
+
+    if (shouldCreateNode) 
+    { 
+        PhaseScope scope("createNode", &this->statistics);
+        createPolyReorderNode(pointOrder); 
+    }
+
+    bool isImporting = !this->importedPointOrder.empty();
 
-    MObject sourceMeshObj = sourceMesh.node();
+    MObject sourceMeshObj = isImporting ? destinationMesh.node() : sourceMesh.node();
     MObject destinationMeshObj = destinationMesh.node();
 
+    const polyReorder::ComponentOrder *destinationComponentOrder = isImporting ? nullptr : &componentOrder;
+
     if (shouldCreateNode && shouldCreateMesh)
     {        
+        PhaseScope scope("connectNode", &this->statistics);
         connectPolyReorderNodeToCreatedMesh();
     } else if (shouldCreateNode) { 
+        PhaseScope scope("connectNode", &this->statistics);
         connectPolyReorderNode();
     } else if (shouldCreateMesh) {
-        polyReorder::reorderMesh(sourceMeshObj, destinationMeshObj, pointOrder, undoCreatedMesh);
+        status = polyReorder::reorderMesh(sourceMeshObj, destinationMeshObj, pointOrder, undoCreatedMesh, false, destinationComponentOrder, &this->statistics, this->progress);
     } else {    
-        status = saveOriginalMesh();
-        RETURN_IF_ERROR(status);
+        {
+            PhaseScope scope("saveOriginalMesh", &this->statistics);
+
+            status = saveOriginalMesh();
+            RETURN_IF_ERROR(status);
+        }
+
+        MFnMesh destinationMeshFn(destinationMesh);
+
+        MIntArray originalCounts;
+        MIntArray originalConnects;
+
+        if (undoOriginalMesh.isNull())
+        {
+            status = destinationMeshFn.getVertices(originalCounts, originalConnects);
+            RETURN_IF_ERROR(status);
+        }
+
+        status = polyReorder::reorderMesh(sourceMeshObj, destinationMeshObj, pointOrder, destinationMeshObj, false, destinationComponentOrder, &this->statistics, this->progress);
+
+        if (!status && !polyReorder::isCancelled(this->progress))
+        {
+            bool isRebuilt = (
+                   !undoOriginalMesh.isNull()
+                || !polyReorder::hasSameFaces(destinationMeshObj, originalCounts, originalConnects, nullptr)
+            );
+
+            if (isRebuilt)
+            {
+                MStatus restoreStatus = restoreOriginalMesh(pointOrder);
+                CHECK_MSTATUS(restoreStatus);
+            }
+        }
+    }
+
+    if (!status || polyReorder::isCancelled(this->progress))
+    {
+        if (!undoCreatedMesh.isNull())
+        {
+            MDagPath createdMesh;
+            MDagPath::getAPathTo(undoCreatedMesh, createdMesh);
+            createdMesh.pop();
+
+            MGlobal::executeCommand("delete " + createdMesh.partialPathName());
+        }
 
-        polyReorder::reorderMesh(sourceMeshObj, destinationMeshObj, pointOrder, destinationMeshObj);
+        undoOriginalMesh = MObject::kNullObj;
+        undoCreatedMesh = MObject::kNullObj;
+
+        return status ? MStatus::kFailure : status;
     }
 
     if (undoCreatedMesh.isNull())
@@ -395,7 +1088,7 @@ MStatus PolyReorderCommand::redoIt()
             oldMesh.pop();
         }
 
-        this->appendToResult(oldMesh.partialPathName());
+        resultName = oldMesh.partialPathName();
     } else {
         MDagPath createdMesh;
         status = MDagPath::getAPathTo(undoCreatedMesh, createdMesh);
@@ -407,17 +1100,96 @@ MStatus PolyReorderCommand::redoIt()
             undoCreatedMesh = createdMesh.node();
         }
 
-        this->appendToResult(createdMesh.partialPathName());
+        resultName = createdMesh.partialPathName();
+    }
+
+    CHECK_MSTATUS(status);
+
+    return status;
+}
+
+
+/**
+    Sets the result to whether the destination mesh is already in the order of
+    the source mesh, without changing either of them.
+*/
+MStatus PolyReorderCommand::checkOrder()
+{
+    if (!polyReorder::hasSameTopology(this->sourceMesh, this->destinationMesh, this->numberOfThreads))
+    {
+        this->setResult(false);
+        return MStatus::kSuccess;
     }
 
-    if (!undoCreatedNode.isNull())
+    MeshTopology sourceMeshTopology;
+    MeshTopology destinationMeshTopology;
+
+    polyReorder::getMeshTopology(this->sourceMesh, sourceMeshTopology);
+    polyReorder::getMeshTopology(this->destinationMesh, destinationMeshTopology);
+
+    if (this->autoMatch && this->destinationComponents.empty())
     {
-        this->appendToResult(MFnDependencyNode(undoCreatedNode).name());
+        bool matchSucceeded = polyReorder::findCorrespondence(
+            sourceMeshTopology.data(),
+            this->sourceComponents,
+            destinationMeshTopology.data(),
+            this->destinationComponents,
+            this->numberOfThreads
+        );
+
+        if (!matchSucceeded)
+        {
+            this->setResult(false);
+            return MStatus::kSuccess;
+        }
     }
 
-    CHECK_MSTATUS(status);
+    bool orderMatches = polyReorder::hasMatchingOrder(
+        sourceMeshTopology, 
+        this->sourceComponents, 
+        destinationMeshTopology, 
+        this->destinationComponents, 
+        this->numberOfThreads
+    );
 
-    return status;
+    this->setResult(orderMatches);
+
+    return MStatus::kSuccess;
+}
+
+
+/**
+    Sets the result to the point order, and writes it to exportOrderPath if
+    one was given, without changing either mesh.
+*/
+MStatus PolyReorderCommand::queryOrder()
+{
+    MStatus status;
+
+    MIntArray pointOrder = getPointOrder(&status);
+
+    if (pointOrder.length() == 0) { status = MStatus::kFailure; }
+
+    RETURN_IF_ERROR(status);
+
+    if (this->exportOrderPath.length() != 0)
+    {
+        std::vector<int> order(pointOrder.length());
+        pointOrder.get(order.data());
+
+        if (!polyReorder::writePointOrderFile(this->exportOrderPath.asChar(), order))
+        {
+            MString errorMessage("polyReorder failed - could not write the point order to ^1s.");
+            errorMessage.format(errorMessage, this->exportOrderPath);
+
+            MGlobal::displayError(errorMessage);
+            return MStatus::kFailure;
+        }
+    }
+
+    this->setResult(pointOrder);
+
+    return MStatus::kSuccess;
 }
 
 
@@ -425,51 +1197,324 @@ MIntArray PolyReorderCommand::getPointOrder(MStatus *status)
 {    
     MIntArray pointOrder;
 
-    MeshTopology sourceMeshTopology(this->sourceMesh);
-    MeshTopology destinationMeshTopology(this->destinationMesh);
+    if (!this->importedPointOrder.empty())
+    {
+        return MIntArray(this->importedPointOrder.data(), (uint) this->importedPointOrder.size());
+    }
 
-    for (polyReorder::ComponentSelection &cs : this->sourceComponents)
+    MeshTopology sourceMeshTopology;
+    MeshTopology destinationMeshTopology;
+
+    {
+        PhaseScope scope("unpackMeshes", &this->statistics);
+
+        polyReorder::getMeshTopology(this->sourceMesh, sourceMeshTopology, this->progress);
+        polyReorder::getMeshTopology(this->destinationMesh, destinationMeshTopology, this->progress);
+    }
+
+    if (polyReorder::isCancelled(this->progress))
+    {
+        if (status) { *status = MStatus::kFailure; }
+        return pointOrder;
+    }
+
+    if (this->autoMatch && this->destinationComponents.empty())
+    {
+        PhaseScope scope("findCorrespondence", &this->statistics);
+
+        bool matchSucceeded = polyReorder::findCorrespondence(
+            sourceMeshTopology.data(),
+            this->sourceComponents,
+            destinationMeshTopology.data(),
+            this->destinationComponents,
+            this->numberOfThreads
+        );
+
+        if (!matchSucceeded)
+        {
+            this->destinationComponents.clear();
+
+            MGlobal::displayError("polyReorder failed - could not match every shell of the source mesh on the destination mesh.");
+            if (status) { *status = MStatus::kFailure; }
+
+            return pointOrder;
+        }
+    }
+
+    std::vector<int> order;
+    polyReorder::WalkMismatch mismatch;
+
+    bool walkSucceeded = false;
+    bool facesLineUp = false;
+
+    {
+        PhaseScope scope("walkMeshes", &this->statistics);
+
+        walkSucceeded = polyReorder::getPointOrder(
+            sourceMeshTopology, 
+            this->sourceComponents, 
+            destinationMeshTopology, 
+            this->destinationComponents, 
+            order,
+            this->numberOfThreads,
+            &mismatch,
+            this->progress
+        );
+    }
+
+    if (polyReorder::isCancelled(this->progress))
     {
-        sourceMeshTopology.walk(cs);
+        if (status) { *status = MStatus::kFailure; }
+        return pointOrder;
     }
 
-    for (polyReorder::ComponentSelection &cs : this->destinationComponents)
+    if (walkSucceeded)
     {
-        destinationMeshTopology.walk(cs);
+        PhaseScope scope("getComponentOrder", &this->statistics);
+        facesLineUp = polyReorder::getComponentOrder(sourceMeshTopology, destinationMeshTopology, order, this->componentOrder);
     }
 
-    if (!sourceMeshTopology.isComplete() || !destinationMeshTopology.isComplete())
+    this->statistics.addValue("sourceBytes", (double) sourceMeshTopology.memoryUsage());
+    this->statistics.addValue("destinationBytes", (double) destinationMeshTopology.memoryUsage());
+    this->statistics.addValue("shells", sourceMeshTopology.numberOfShells());
+    this->statistics.addValue("visitedVertices", sourceMeshTopology.numberOfVisitedVertices());
+    this->statistics.addValue("visitedEdges", sourceMeshTopology.numberOfVisitedEdges());
+    this->statistics.addValue("visitedFaces", sourceMeshTopology.numberOfVisitedFaces());
+
+    if (!walkSucceeded && mismatch.selection != -1)
     {
+        MString errorMessage("polyReorder failed - the meshes stop matching at ^1s.f[^2s] and ^3s.f[^4s]");
+        MString sourceFace;
+        sourceFace += mismatch.sourceFace;
+        MString destinationFace;
+        destinationFace += mismatch.destinationFace;
+
+        errorMessage.format(errorMessage, this->sourceMesh.partialPathName(), sourceFace, this->destinationMesh.partialPathName(), destinationFace);
+
+        if (mismatch.sourceVertex != -1 && mismatch.destinationVertex != -1)
+        {
+            MString vertexMessage(", near ^1s.vtx[^2s] and ^3s.vtx[^4s]");
+            MString sourceVertex;
+            sourceVertex += mismatch.sourceVertex;
+            MString destinationVertex;
+            destinationVertex += mismatch.destinationVertex;
+
+            vertexMessage.format(vertexMessage, this->sourceMesh.partialPathName(), sourceVertex, this->destinationMesh.partialPathName(), destinationVertex);
+            errorMessage += vertexMessage;
+        }
+
+        errorMessage += ". Check the components selected on this shell and try again.";
+
+        MGlobal::displayError(errorMessage);
+        if (status) { *status = MStatus::kFailure; }
+    } else if (!walkSucceeded) {
         MGlobal::displayError("polyReorder failed - components may not have been selected on all shells. Check your arguments and try again.");
-        status = new MStatus(MStatus::kFailure);
+        if (status) { *status = MStatus::kFailure; }
+    } else if (!facesLineUp) {
+        MGlobal::displayError("polyReorder failed - the faces of the meshes do not line up.");
+        if (status) { *status = MStatus::kFailure; }
     } else {
-        pointOrder.setLength(sourceMeshTopology.numberOfVertices());
+        pointOrder = MIntArray(order.data(), (uint) order.size());
+    }
+
+    return pointOrder;
+}
+
+
+/**
+    Reads the source once and walks it once from its selections, then
+    matches every destination against that walk at the same time. Each
+    destination only reads the source, so they share it safely.
+*/
+MStatus PolyReorderCommand::getBatchPointOrders()
+{
+    int numberOfDestinations = (int) this->batch.size();
+
+    MeshTopology sourceMeshTopology;
+    std::vector<MeshTopology> destinationMeshTopologies(numberOfDestinations);
+
+    {
+        PhaseScope scope("unpackMeshes", &this->statistics);
+
+        polyReorder::getMeshTopology(this->sourceMesh, sourceMeshTopology, this->progress);
+
+        for (int i = 0; i < numberOfDestinations && !polyReorder::isCancelled(this->progress); i++)
+        {
+            polyReorder::getMeshTopology(this->batch[i].mesh, destinationMeshTopologies[i], this->progress);
+        }
+    }
+
+    if (polyReorder::isCancelled(this->progress))
+    {
+        return MStatus::kFailure;
+    }
+
+    for (polyReorder::ComponentSelection &cs : this->sourceComponents)
+    {
+        if (!polyReorder::isValidSelection(sourceMeshTopology.data(), cs))
+        {
+            MGlobal::displayError("Component selection must be an edge on a face, and a vertex on that edge.");
+            return MStatus::kFailure;
+        }
+    }
+
+    for (int i = 0; i < numberOfDestinations; i++)
+    {
+        polyReorder::BatchDestination &destination = this->batch[i];
 
-        for (uint i = 0; i < pointOrder.length(); i++)
+        for (polyReorder::ComponentSelection &cs : destination.components)
         {
-            if (destinationMeshTopology[i] == -1 || sourceMeshTopology[i] == -1)
+            if (!polyReorder::isValidSelection(destinationMeshTopologies[i].data(), cs))
             {
-                status = new MStatus(MStatus::kFailure);
-                break;
+                MString errorMessage("Component selection on ^1s must be an edge on a face, and a vertex on that edge.");
+                errorMessage.format(errorMessage, destination.mesh.partialPathName());
+
+                MGlobal::displayError(errorMessage);
+                return MStatus::kFailure;
             }
+        }
+    }
 
-            pointOrder[destinationMeshTopology[i]] = sourceMeshTopology[i];
+    if (this->autoMatch && this->sourceComponents.empty())
+    {
+        PhaseScope scope("findCorrespondence", &this->statistics);
+
+        bool matchSucceeded = polyReorder::findCorrespondence(
+            sourceMeshTopology.data(),
+            this->sourceComponents,
+            destinationMeshTopologies[0].data(),
+            this->batch[0].components,
+            this->numberOfThreads
+        );
+
+        if (!matchSucceeded)
+        {
+            MString errorMessage("polyReorder failed - could not match every shell of ^1s on ^2s.");
+            errorMessage.format(errorMessage, this->sourceMesh.partialPathName(), this->batch[0].mesh.partialPathName());
+
+            MGlobal::displayError(errorMessage);
+            return MStatus::kFailure;
         }
     }
 
-    return pointOrder;
+    {
+        PhaseScope scope("walkSource", &this->statistics);
+        sourceMeshTopology.walk(this->sourceComponents, this->numberOfThreads, this->progress);
+    }
+
+    if (polyReorder::isCancelled(this->progress))
+    {
+        return MStatus::kFailure;
+    }
+
+    if (!sourceMeshTopology.isComplete())
+    {
+        MGlobal::displayError("polyReorder failed - components may not have been selected on all shells. Check your arguments and try again.");
+        return MStatus::kFailure;
+    }
+
+    std::vector<char> succeeded(numberOfDestinations, false);
+
+    {
+        PhaseScope scope("matchDestinations", &this->statistics);
+
+        polyReorder::parallelFor(numberOfDestinations, this->numberOfThreads, [&](int i)
+        {
+            polyReorder::BatchDestination &destination = this->batch[i];
+
+            auto start = std::chrono::steady_clock::now();
+
+            bool matchSucceeded = !destination.components.empty() || polyReorder::findCorrespondence(
+                sourceMeshTopology.data(),
+                this->sourceComponents,
+                destinationMeshTopologies[i].data(),
+                destination.components,
+                1
+            );
+
+            std::vector<int> order;
+
+            succeeded[i] = matchSucceeded && polyReorder::getWalkedPointOrder(
+                sourceMeshTopology,
+                destinationMeshTopologies[i],
+                destination.components,
+                order,
+                destination.componentOrder,
+                1,
+                this->progress
+            );
+
+            if (succeeded[i])
+            {
+                destination.pointOrder = MIntArray(order.data(), (uint) order.size());
+            }
+
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            destination.milliseconds = elapsed.count();
+        });
+    }
+
+    if (polyReorder::isCancelled(this->progress))
+    {
+        return MStatus::kFailure;
+    }
+
+    size_t destinationBytes = 0;
+
+    for (MeshTopology &destinationMeshTopology : destinationMeshTopologies)
+    {
+        destinationBytes += destinationMeshTopology.memoryUsage();
+    }
+
+    this->statistics.addValue("sourceBytes", (double) sourceMeshTopology.memoryUsage());
+    this->statistics.addValue("destinationBytes", (double) destinationBytes);
+    this->statistics.addValue("shells", sourceMeshTopology.numberOfShells());
+    this->statistics.addValue("visitedVertices", sourceMeshTopology.numberOfVisitedVertices());
+    this->statistics.addValue("visitedEdges", sourceMeshTopology.numberOfVisitedEdges());
+    this->statistics.addValue("visitedFaces", sourceMeshTopology.numberOfVisitedFaces());
+
+    for (int i = 0; i < numberOfDestinations; i++)
+    {
+        if (!succeeded[i])
+        {
+            MString errorMessage("polyReorder failed - ^1s does not match ^2s from the components given. Check the components selected on each shell and try again.");
+            errorMessage.format(errorMessage, this->batch[i].mesh.partialPathName(), this->sourceMesh.partialPathName());
+
+            MGlobal::displayError(errorMessage);
+            return MStatus::kFailure;
+        }
+    }
+
+    return MStatus::kSuccess;
 }
 
 
+/**
+    Keeps what undo needs to put the destination back after it is reordered
+    in place. That is nothing beyond the orders, which the command holds
+    anyway, when restoreMesh can rebuild the mesh from them exactly - only
+    otherwise is the whole mesh copied here. restoreOriginalMesh copies the
+    reordered mesh at undo instead, to fall back on if the rebuild fails.
+*/
 MStatus PolyReorderCommand::saveOriginalMesh()
 {
     MStatus status;
 
+    undoOriginalMesh = MObject::kNullObj;
+
+    MObject originalMesh = destinationMesh.node();
+
+    bool canUndoByOrder = importedPointOrder.empty() && polyReorder::canRestoreMesh(originalMesh);
+
+    if (canUndoByOrder)
+    {
+        return MStatus::kSuccess;
+    }
+
     MFnMeshData undoOriginalMeshData;
     undoOriginalMesh = undoOriginalMeshData.create();
 
     MFnMesh destinationMeshFn(destinationMesh);
-    MObject originalMesh = destinationMesh.node();
     destinationMeshFn.copy(originalMesh, undoOriginalMesh, &status);
     CHECK_MSTATUS_AND_RETURN_IT(status);
 
@@ -477,12 +1522,42 @@ MStatus PolyReorderCommand::saveOriginalMesh()
 }
 
 
-MStatus PolyReorderCommand::restoreOriginalMesh()
+/**
+    Puts the destination back as it was before it was reordered in place.
+    Without a saved copy the mesh is rebuilt from the orders, and the
+    reordered mesh is copied first, so that a rebuild that fails part way
+    through can fall back to it and leave the mesh whole.
+*/
+MStatus PolyReorderCommand::restoreOriginalMesh(MIntArray &pointOrder)
 {
     MStatus status;
     parseArgs::extendToShape(destinationMesh);
 
     MFnMesh destinationMeshFn(destinationMesh);
+
+    if (undoOriginalMesh.isNull())
+    {
+        MObject mesh = destinationMesh.node();
+
+        MFnMeshData reorderedMeshData;
+        MObject reorderedMesh = reorderedMeshData.create();
+
+        destinationMeshFn.copy(mesh, reorderedMesh, &status);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        status = polyReorder::restoreMesh(mesh, pointOrder, componentOrder);
+
+        if (!status)
+        {
+            MGlobal::displayError("polyReorder failed - could not restore the original mesh, it was left reordered.");
+
+            MStatus copyStatus = destinationMeshFn.copyInPlace(reorderedMesh);
+            CHECK_MSTATUS(copyStatus);
+        }
+
+        return status;
+    }
+
     status = destinationMeshFn.copyInPlace(undoOriginalMesh);
     CHECK_MSTATUS_AND_RETURN_IT(status);
 
@@ -505,13 +1580,18 @@ MStatus PolyReorderCommand::createPolyReorderNode(MIntArray &pointOrder)
     MFnDependencyNode createdNodeFn(undoCreatedNode, &status);
     CHECK_MSTATUS_AND_RETURN_IT(status);
 
-    MPlug pointOrderPlug = createdNodeFn.findPlug("pointOrder", false, &status);
+    MPlug pointOrderPlug = createdNodeFn.findPlug("storedPointOrder", false, &status);
     CHECK_MSTATUS_AND_RETURN_IT(status);
 
-    MFnIntArrayData pointOrderArrayData;
-    MObject pointOrderData = pointOrderArrayData.create(pointOrder, &status);
+    MFnPluginData pointOrderDataFn;
+    MObject pointOrderData = pointOrderDataFn.create(PointOrderData::TYPE_ID, &status);
     CHECK_MSTATUS_AND_RETURN_IT(status);
 
+    std::vector<int> order(pointOrder.length());
+    pointOrder.get(order.data());
+
+    ((PointOrderData*) pointOrderDataFn.data())->setPointOrder(order);
+
     status = pointOrderPlug.setMObject(pointOrderData);
     CHECK_MSTATUS_AND_RETURN_IT(status);
 
@@ -672,9 +1752,22 @@ MStatus PolyReorderCommand::connectPolyReorderNodeToCreatedMesh()
 
 
 MStatus PolyReorderCommand::undoIt()
+{
+    if (!this->batch.empty())
+    {
+        return this->undoBatch(this->batch.size());
+    }
+
+    return this->undoDestination(this->cachedPointOrder);
+}
+
+
+MStatus PolyReorderCommand::undoDestination(MIntArray &pointOrder)
 {
     MStatus status;
 
+    if (orderUnchanged) { return MStatus::kSuccess; }
+
     bool createdMesh = !undoCreatedMesh.isNull();
     bool createdNode = !undoCreatedNode.isNull();
 
@@ -711,7 +1804,7 @@ MStatus PolyReorderCommand::undoIt()
         status = MGlobal::executeCommand(deleteCmd);
         CHECK_MSTATUS_AND_RETURN_IT(status);
     } else {
-        status = restoreOriginalMesh();
+        status = restoreOriginalMesh(pointOrder);
     }
 
     return status;
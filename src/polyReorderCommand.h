@@ -6,6 +6,7 @@
 #ifndef POLY_REORDER_COMMAND_H
 #define POLY_REORDER_COMMAND_H
 
+#include "phaseStatistics.h"
 #include "polyReorder.h"
 
 #include <vector>
@@ -38,6 +39,50 @@
 #define DESTINATION_COMPONENTS_FLAG         "-dc"
 #define DESTINATION_COMPONENTS_LONG_FLAG    "-destinationComponents"
 
+#define AUTO_MATCH_FLAG                     "-am"
+#define AUTO_MATCH_LONG_FLAG                "-autoMatch"
+
+#define NUMBER_OF_THREADS_FLAG              "-nt"
+#define NUMBER_OF_THREADS_LONG_FLAG         "-numThreads"
+
+#define CHECK_ORDER_FLAG                    "-co"
+#define CHECK_ORDER_LONG_FLAG               "-checkOrder"
+
+#define QUERY_ORDER_FLAG                    "-qo"
+#define QUERY_ORDER_LONG_FLAG               "-queryOrder"
+
+#define EXPORT_ORDER_FLAG                   "-eo"
+#define EXPORT_ORDER_LONG_FLAG              "-exportOrder"
+
+#define IMPORT_ORDER_FLAG                   "-io"
+#define IMPORT_ORDER_LONG_FLAG              "-importOrder"
+
+#define STATISTICS_FLAG                     "-st"
+#define STATISTICS_LONG_FLAG                "-statistics"
+
+namespace polyReorder
+{
+    /**
+        One destination of a command given more than one -destinationMesh,
+        with everything the command keeps for it between redo and undo.
+    */
+    struct BatchDestination
+    {
+        MDagPath                            mesh;
+        std::vector<ComponentSelection>     components;
+
+        MIntArray                           pointOrder;
+        ComponentOrder                      componentOrder;
+
+        bool                                orderUnchanged      = false;
+        double                              milliseconds        = 0.0;
+
+        MObject                             undoOriginalMesh;
+        MObject                             undoCreatedNode;
+        MObject                             undoCreatedMesh;
+    };
+}
+
 class PolyReorderCommand : public MPxCommand
 {
 public:
@@ -52,16 +97,31 @@ public:
                                                 const char* flag, MDagPath &mesh, 
                                                 std::vector<polyReorder::ComponentSelection> &componentSelection);
 
+    virtual MStatus     parseBatchArguments(MArgDatabase &argsData);
+
     virtual MStatus     validateArguments();
+    virtual MStatus     validateBatchArguments();
+    virtual MStatus     validateImportArguments();
 
     virtual MStatus     doIt(const MArgList& argList);
     virtual MStatus     redoIt();
     virtual MStatus     undoIt();
 
     virtual MStatus     saveOriginalMesh();
-    virtual MStatus     restoreOriginalMesh();
+    virtual MStatus     restoreOriginalMesh(MIntArray &pointOrder);
+
+    virtual MStatus     redoBatch();
+    virtual MStatus     undoBatch(size_t numberApplied);
+    virtual MStatus     applyPointOrder(MIntArray &pointOrder, MString &resultName);
+    virtual MStatus     undoDestination(MIntArray &pointOrder);
 
+    virtual void        loadDestination(polyReorder::BatchDestination &destination);
+    virtual void        storeDestination(polyReorder::BatchDestination &destination);
+
+    virtual MStatus     checkOrder();
+    virtual MStatus     queryOrder();
     virtual MIntArray   getPointOrder(MStatus *status);
+    virtual MStatus     getBatchPointOrders();
     virtual MStatus     createPolyReorderNode(MIntArray &pointOrder);
     virtual MStatus     createNewMesh();
     
@@ -69,7 +129,7 @@ public:
     virtual MStatus     disconnectPolyReorderNode();
     virtual MStatus     connectPolyReorderNodeToCreatedMesh();
 
-    virtual bool        isUndoable() const { return true; }
+    virtual bool        isUndoable() const { return !checkOrderOnly && !queryOrderOnly; }
     virtual bool        hasSyntax()  const { return true; }
 
 public:
@@ -79,12 +139,31 @@ private:
     std::vector<polyReorder::ComponentSelection> sourceComponents;
     std::vector<polyReorder::ComponentSelection> destinationComponents;
 
+    polyReorder::ComponentOrder componentOrder;
+
     bool                    replaceOriginal     = true;
     bool                    constructionHistory = false;
+    bool                    autoMatch           = false;
+    bool                    checkOrderOnly      = false;
+    bool                    queryOrderOnly      = false;
+    bool                    orderUnchanged      = false;
+    bool                    showStatistics      = false;
+    int                     numberOfThreads     = 0;
         
     MDagPath                sourceMesh;
     MDagPath                destinationMesh;
 
+    std::vector<polyReorder::BatchDestination> batch;
+
+    MIntArray               cachedPointOrder;
+
+    MString                 exportOrderPath;
+    MString                 importOrderPath;
+    std::vector<int>        importedPointOrder;
+
+    PhaseStatistics         statistics;
+    Progress                *progress           = nullptr;
+
     MObject                 undoOriginalMesh;
     MObject                 undoCreatedNode;
     MObject                 undoCreatedMesh;
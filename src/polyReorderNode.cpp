@@ -3,18 +3,28 @@
     You may use, distribute, or modify this code under the terms of the MIT license.
 */
 
+#include "correspondence.h"
+#include "meshTopology.h"
+#include "parallel.h"
+#include "pointOrderData.h"
 #include "polyReorder.h"
 #include "polyReorderNode.h"
 
+#include <mutex>
 #include <stdio.h>
 #include <vector>
 
+#include <maya/MArrayDataBuilder.h>
+#include <maya/MArrayDataHandle.h>
 #include <maya/MDataBlock.h>
 #include <maya/MDataHandle.h>
+#include <maya/MFloatPointArray.h>
 #include <maya/MFnData.h>
 #include <maya/MFnIntArrayData.h>
 #include <maya/MFnMesh.h>
 #include <maya/MFnMeshData.h>
+#include <maya/MFnNumericAttribute.h>
+#include <maya/MFnNumericData.h>
 #include <maya/MFnTypedAttribute.h>
 #include <maya/MGlobal.h>
 #include <maya/MIntArray.h>
@@ -30,8 +40,15 @@
 
 
 MObject PolyReorderNode::inMeshAttr;
+MObject PolyReorderNode::inMeshesAttr;
 MObject PolyReorderNode::pointOrderAttr;
+MObject PolyReorderNode::storedPointOrderAttr;
+MObject PolyReorderNode::sourceMeshAttr;
+MObject PolyReorderNode::sourceComponentsAttr;
+MObject PolyReorderNode::destinationComponentsAttr;
+MObject PolyReorderNode::numberOfThreadsAttr;
 MObject PolyReorderNode::outMeshAttr;
+MObject PolyReorderNode::outMeshesAttr;
 
 
 void* PolyReorderNode::creator()
@@ -44,81 +61,797 @@ MStatus PolyReorderNode::initialize()
 {
     MStatus status;
 
+    MFnNumericAttribute N;
     MFnTypedAttribute T;
     
     inMeshAttr = T.create("inMesh", "im", MFnData::kMesh, MObject::kNullObj, &status);
     CHECK_MSTATUS_AND_RETURN_IT(status);
 
+    inMeshesAttr = T.create("inMeshes", "ims", MFnData::kMesh, MObject::kNullObj, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    T.setArray(true);
+
     pointOrderAttr = T.create("pointOrder", "po", MFnData::kIntArray, MObject::kNullObj, &status);
     CHECK_MSTATUS_AND_RETURN_IT(status);
 
+    storedPointOrderAttr = T.create("storedPointOrder", "spo", PointOrderData::TYPE_ID, MObject::kNullObj, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    sourceMeshAttr = T.create("sourceMesh", "sm", MFnData::kMesh, MObject::kNullObj, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    sourceComponentsAttr = T.create("sourceComponents", "sc", MFnData::kIntArray, MObject::kNullObj, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    destinationComponentsAttr = T.create("destinationComponents", "dc", MFnData::kIntArray, MObject::kNullObj, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    numberOfThreadsAttr = N.create("numberOfThreads", "nt", MFnNumericData::kInt, 1, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    N.setMin(0);
+
     outMeshAttr = T.create("outMesh", "om", MFnData::kMesh, MObject::kNullObj, &status);
     CHECK_MSTATUS_AND_RETURN_IT(status);
 
     T.setStorable(false);
 
+    outMeshesAttr = T.create("outMeshes", "oms", MFnData::kMesh, MObject::kNullObj, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    T.setStorable(false);
+    T.setArray(true);
+    T.setUsesArrayDataBuilder(true);
+
     CHECK_MSTATUS_AND_RETURN_IT(addAttribute(inMeshAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(addAttribute(inMeshesAttr));
     CHECK_MSTATUS_AND_RETURN_IT(addAttribute(pointOrderAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(addAttribute(storedPointOrderAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(addAttribute(sourceMeshAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(addAttribute(sourceComponentsAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(addAttribute(destinationComponentsAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(addAttribute(numberOfThreadsAttr));
     CHECK_MSTATUS_AND_RETURN_IT(addAttribute(outMeshAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(addAttribute(outMeshesAttr));
 
     CHECK_MSTATUS_AND_RETURN_IT(attributeAffects(inMeshAttr, outMeshAttr));
     CHECK_MSTATUS_AND_RETURN_IT(attributeAffects(pointOrderAttr, outMeshAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(attributeAffects(storedPointOrderAttr, outMeshAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(attributeAffects(sourceMeshAttr, outMeshAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(attributeAffects(sourceComponentsAttr, outMeshAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(attributeAffects(destinationComponentsAttr, outMeshAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(attributeAffects(numberOfThreadsAttr, outMeshAttr));
+
+    CHECK_MSTATUS_AND_RETURN_IT(attributeAffects(inMeshesAttr, outMeshesAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(attributeAffects(pointOrderAttr, outMeshesAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(attributeAffects(storedPointOrderAttr, outMeshesAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(attributeAffects(sourceMeshAttr, outMeshesAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(attributeAffects(sourceComponentsAttr, outMeshesAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(attributeAffects(destinationComponentsAttr, outMeshesAttr));
+    CHECK_MSTATUS_AND_RETURN_IT(attributeAffects(numberOfThreadsAttr, outMeshesAttr));
 
     return status;
 }
 
 
+/**
+    Nothing in compute touches global state or the UI directly. Errors are
+    handed to reportError, and everything the node remembers between
+    evaluations belongs to this instance and sits behind cacheMutex, so the
+    node can run on any thread the evaluation manager picks.
+*/
 MStatus PolyReorderNode::compute(const MPlug &plug, MDataBlock &dataBlock)
 {
-    MStatus status;
+    if (plug == outMeshAttr) 
+    { 
+        return computeMesh(dataBlock); 
+    }
 
-    if (plug != outMeshAttr) { return MStatus::kUnknownParameter; }
+    if (plug == outMeshesAttr || (plug.isElement() && plug.array() == outMeshesAttr))
+    {
+        return computeMeshes(dataBlock);
+    }
+
+    return MStatus::kUnknownParameter;
+}
 
-    MDataHandle inMeshHandle = dataBlock.inputValue(inMeshAttr, &status);
-    CHECK_MSTATUS_AND_RETURN_IT(status);
 
-    MDataHandle pointOrderHandle = dataBlock.inputValue(pointOrderAttr, &status);
+MStatus PolyReorderNode::computeMesh(MDataBlock &dataBlock)
+{
+    MStatus status;
+
+    MDataHandle inMeshHandle = dataBlock.inputValue(inMeshAttr, &status);
     CHECK_MSTATUS_AND_RETURN_IT(status);
 
     MDataHandle outMeshHandle = dataBlock.outputValue(outMeshAttr, &status);
     CHECK_MSTATUS_AND_RETURN_IT(status);
 
     MObject inMesh = inMeshHandle.asMesh();
-    MObject pointOrderData = pointOrderHandle.data();
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    status = getNumberOfThreads(dataBlock);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    const std::vector<int> *order = nullptr;
+    uint64_t pointOrderKey = 0;
+    MeshResult result;
+
+    status = getPointOrder(dataBlock, inMesh, order, pointOrderKey, result.error);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    if (result.error.length() == 0)
+    {
+        reorderElement(inMesh, *order, pointOrderKey, numberOfThreads, result);
+    } else {
+        result.outMesh = inMesh;
+    }
+
+    if (result.error.length() > 0)
+    {
+        reportError(result.error);
+    } else {
+        lastError.clear();
+    }
+
+    if (result.rebuilt)
+    {
+        setCache(result.outMesh, result.meshKey, pointOrderKey);
+    }
+
+    if (!result.outMesh.isNull())
+    {
+        status = outMeshHandle.setMObject(result.outMesh);    
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+    }
+    
+    outMeshHandle.setClean();
+
+    return MStatus::kSuccess;
+}
+
+
+/**
+    Every element shares the pointOrder and the cached mesh. The first element
+    is reordered on its own, so that if it has to be rebuilt, the rest can
+    start from its result. The others are read on this thread, hashed and
+    matched against the cache across up to numberOfThreads threads, one
+    element per thread, and then written back on this thread - reorderMesh,
+    MFnMeshData::create and setPoints are Maya API calls, which must not run
+    on threads Maya did not start. The outputs are set together once all of
+    them are done.
+*/
+MStatus PolyReorderNode::computeMeshes(MDataBlock &dataBlock)
+{
+    MStatus status;
+
+    MArrayDataHandle inMeshesHandle = dataBlock.inputArrayValue(inMeshesAttr, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    int numberOfMeshes = (int) inMeshesHandle.elementCount();
+
+    std::vector<MObject> inMeshes(numberOfMeshes);
+    std::vector<unsigned> logicalIndices(numberOfMeshes);
+
+    for (int i = 0; i < numberOfMeshes; i++)
+    {
+        status = inMeshesHandle.jumpToArrayElement(i);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        logicalIndices[i] = inMeshesHandle.elementIndex();
+        inMeshes[i] = inMeshesHandle.inputValue().asMesh();
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    status = getNumberOfThreads(dataBlock);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    const std::vector<int> *order = nullptr;
+    uint64_t pointOrderKey = 0;
+    std::vector<MeshResult> results(numberOfMeshes);
+
+    MObject firstMesh = numberOfMeshes > 0 ? inMeshes[0] : MObject::kNullObj;
+    MString orderError;
+
+    status = getPointOrder(dataBlock, firstMesh, order, pointOrderKey, orderError);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    if (orderError.length() > 0)
+    {
+        for (int i = 0; i < numberOfMeshes; i++)
+        {
+            results[i].outMesh = inMeshes[i];
+            results[i].error = orderError;
+        }
+    } else if (numberOfMeshes > 0) {
+        reorderElement(inMeshes[0], *order, pointOrderKey, numberOfThreads, results[0]);
+
+        if (results[0].rebuilt)
+        {
+            setCache(results[0].outMesh, results[0].meshKey, pointOrderKey);
+        }
+
+        std::vector<ElementWork> work(numberOfMeshes);
+
+        for (int i = 1; i < numberOfMeshes; i++)
+        {
+            readElement(inMeshes[i], *order, work[i], results[i]);
+        }
+
+        bool hasCache = !cachedMesh.isNull();
+
+        polyReorder::parallelFor(numberOfMeshes - 1, numberOfThreads, [&](int i)
+        {
+            matchElement(*order, pointOrderKey, hasCache, 1, work[i + 1], results[i + 1]);
+        });
+
+        for (int i = 1; i < numberOfMeshes; i++)
+        {
+            writeElement(inMeshes[i], *order, work[i], results[i]);
+        }
+    }
+
+    MArrayDataHandle outMeshesHandle = dataBlock.outputArrayValue(outMeshesAttr, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    MArrayDataBuilder builder(&dataBlock, outMeshesAttr, numberOfMeshes, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    MString error;
+
+    for (int i = 0; i < numberOfMeshes; i++)
+    {
+        if (error.length() == 0) { error = results[i].error; }
+
+        if (results[i].outMesh.isNull()) { continue; }
+
+        MDataHandle outMeshHandle = builder.addElement(logicalIndices[i], &status);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        status = outMeshHandle.setMObject(results[i].outMesh);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+    }
+
+    if (error.length() > 0)
+    {
+        reportError(error);
+    } else {
+        lastError.clear();
+    }
+
+    status = outMeshesHandle.set(builder);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    outMeshesHandle.setAllClean();
+
+    return MStatus::kSuccess;
+}
+
+
+/**
+    With a sourceMesh connected, the order is worked out from the seeds by
+    walking sourceMesh and destinationMesh together; see computePointOrder.
+    Otherwise pointOrder is used when it has any entries, so older scenes
+    keep working, and storedPointOrder when it does not.
+
+    order is pointed at wherever the order is kept rather than copied, and
+    pointOrderKey is its hash. Only the pointOrder attribute has to be read
+    and hashed again on every evaluation; the stored and computed orders
+    were hashed when they were made.
+
+    A failure that means the input should pass through unchanged sets error
+    rather than the returned status.
+*/
+MStatus PolyReorderNode::getPointOrder(
+    MDataBlock &dataBlock, 
+    MObject &destinationMesh, 
+    const std::vector<int>* &order, 
+    uint64_t &pointOrderKey, 
+    MString &error
+) {
+    MStatus status;
+
+    MDataHandle sourceMeshHandle = dataBlock.inputValue(sourceMeshAttr, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    MObject sourceMesh = sourceMeshHandle.asMesh();
+
+    if (!sourceMesh.isNull())
+    {
+        MIntArray sourceComponents;
+        MIntArray destinationComponents;
+
+        status = getIntArray(dataBlock, sourceComponentsAttr, sourceComponents);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        status = getIntArray(dataBlock, destinationComponentsAttr, destinationComponents);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        status = computePointOrder(sourceMesh, sourceComponents, destinationMesh, destinationComponents, error);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        order = &computedOrder;
+        pointOrderKey = computedPointOrderKey;
+
+        return MStatus::kSuccess;
+    }
+
+    MDataHandle storedPointOrderHandle = dataBlock.inputValue(storedPointOrderAttr, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
 
     MIntArray pointOrder;
 
-    if (!pointOrderData.isNull())
+    status = getIntArray(dataBlock, pointOrderAttr, pointOrder);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    PointOrderData *storedPointOrder = (PointOrderData*) storedPointOrderHandle.asPluginData();
+
+    if (pointOrder.length() == 0 && storedPointOrder != nullptr)
+    {
+        order = &storedPointOrder->pointOrder();
+        pointOrderKey = storedPointOrder->pointOrderKey();
+
+        return MStatus::kSuccess;
+    }
+
+    attributeOrder.resize(pointOrder.length());
+    pointOrder.get(attributeOrder.data());
+
+    order = &attributeOrder;
+    pointOrderKey = polyReorder::hashValues(attributeOrder.data(), attributeOrder.size(), 0, numberOfThreads);
+
+    return MStatus::kSuccess;
+}
+
+
+/**
+    Works out the order that makes destinationMesh match sourceMesh, starting
+    from (vertex, edge, face) seed triplets on each. With no destination seeds
+    they are matched automatically, as with the command's -autoMatch flag.
+
+    The result - or the reason there is none - is cached against the
+    face-vertex lists of both meshes and the seeds, so the walk only runs
+    again when one of them changes. Renumbering the destination upstream
+    changes its lists even when its shape does not, so the order follows it.
+*/
+MStatus PolyReorderNode::computePointOrder(
+    MObject &sourceMesh, 
+    MIntArray &sourceComponents, 
+    MObject &destinationMesh, 
+    MIntArray &destinationComponents, 
+    MString &error
+) {
+    MStatus status;
+
+    if (destinationMesh.isNull()) 
+    { 
+        hasComputedOrder = false;
+        computedOrder.clear();
+        computedPointOrderKey = 0;
+
+        return MStatus::kSuccess; 
+    }
+
+    MFnMesh sourceMeshFn(sourceMesh, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    MFnMesh destinationMeshFn(destinationMesh, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    MIntArray polyCounts;
+    MIntArray polyConnects;
+
+    status = sourceMeshFn.getVertices(polyCounts, polyConnects);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    uint64_t orderKey = polyReorder::hashArray(polyCounts, 0, numberOfThreads);
+    orderKey = polyReorder::hashArray(polyConnects, orderKey, numberOfThreads);
+
+    status = destinationMeshFn.getVertices(polyCounts, polyConnects);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    orderKey = polyReorder::hashArray(polyCounts, orderKey, numberOfThreads);
+    orderKey = polyReorder::hashArray(polyConnects, orderKey, numberOfThreads);
+    orderKey = polyReorder::hashArray(sourceComponents, orderKey);
+    orderKey = polyReorder::hashArray(destinationComponents, orderKey);
+
+    if (!hasComputedOrder || orderKey != computedOrderKey)
     {
-        MFnIntArrayData pointOrderDataFn(pointOrderData, &status);               
+        hasComputedOrder = false;
+        computedOrderError.clear();
+
+        status = walkPointOrder(
+            sourceMesh, 
+            sourceComponents, 
+            destinationMesh, 
+            destinationComponents, 
+            computedOrder, 
+            computedOrderError, 
+            numberOfThreads
+        );
         CHECK_MSTATUS_AND_RETURN_IT(status);
-        pointOrder = pointOrderDataFn.array(&status);                      
+
+        if (computedOrderError.length() > 0) 
+        { 
+            computedOrder.clear(); 
+        }
+
+        hasComputedOrder = true;
+        computedOrderKey = orderKey;
+        computedPointOrderKey = polyReorder::hashValues(computedOrder.data(), computedOrder.size(), 0, numberOfThreads);
+    }
+
+    error = computedOrderError;
+
+    return MStatus::kSuccess;
+}
+
+
+MStatus PolyReorderNode::walkPointOrder(
+    MObject &sourceMesh, 
+    MIntArray &sourceComponents, 
+    MObject &destinationMesh, 
+    MIntArray &destinationComponents, 
+    std::vector<int> &order, 
+    MString &error,
+    int numberOfThreads
+) {
+    MStatus status;
+
+    std::vector<polyReorder::ComponentSelection> sourceSeeds;
+    std::vector<polyReorder::ComponentSelection> destinationSeeds;
+
+    getSeeds(sourceComponents, sourceSeeds);
+    getSeeds(destinationComponents, destinationSeeds);
+
+    int numVertices;
+    std::vector<int> counts;
+    std::vector<int> connects;
+    std::vector<int> edgeVertices;
+
+    MeshTopology sourceTopology;
+    MeshTopology destinationTopology;
+
+    status = polyReorder::getMeshArrays(sourceMesh, numVertices, counts, connects, edgeVertices);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    sourceTopology.setMesh(numVertices, counts, connects, edgeVertices);
+
+    polyReorder::TopologyFingerprint sourceFingerprint = polyReorder::getTopologyFingerprint(
+        numVertices, 
+        (int) edgeVertices.size() / 2, 
+        counts, 
+        connects, 
+        3, 
+        numberOfThreads
+    );
+
+    status = polyReorder::getMeshArrays(destinationMesh, numVertices, counts, connects, edgeVertices);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    destinationTopology.setMesh(numVertices, counts, connects, edgeVertices);
+
+    polyReorder::TopologyFingerprint destinationFingerprint = polyReorder::getTopologyFingerprint(
+        numVertices, 
+        (int) edgeVertices.size() / 2, 
+        counts, 
+        connects, 
+        3, 
+        numberOfThreads
+    );
+
+    if (sourceFingerprint != destinationFingerprint)
+    {
+        error = "polyReorder node - sourceMesh and inMesh do not have the same topology.";
+        return MStatus::kSuccess;
+    }
+
+    for (polyReorder::ComponentSelection &cs : sourceSeeds)
+    {
+        if (!polyReorder::isValidSelection(sourceTopology.data(), cs))
+        {
+            error = "polyReorder node - sourceComponents must be a vertex on an edge on a face.";
+            return MStatus::kSuccess;
+        }
+    }
+
+    for (polyReorder::ComponentSelection &cs : destinationSeeds)
+    {
+        if (!polyReorder::isValidSelection(destinationTopology.data(), cs))
+        {
+            error = "polyReorder node - destinationComponents must be a vertex on an edge on a face.";
+            return MStatus::kSuccess;
+        }
+    }
+
+    if (destinationSeeds.empty())
+    {
+        bool matchSucceeded = polyReorder::findCorrespondence(
+            sourceTopology.data(), 
+            sourceSeeds, 
+            destinationTopology.data(), 
+            destinationSeeds, 
+            numberOfThreads
+        );
+
+        if (!matchSucceeded)
+        {
+            error = "polyReorder node - could not match every shell of sourceMesh on inMesh.";
+            return MStatus::kSuccess;
+        }
+    }
+
+    bool walkSucceeded = polyReorder::getPointOrder(
+        sourceTopology, 
+        sourceSeeds, 
+        destinationTopology, 
+        destinationSeeds, 
+        order, 
+        numberOfThreads
+    );
+
+    if (!walkSucceeded)
+    {
+        error = "polyReorder node - the meshes do not match from the given components.";
+    }
+
+    return MStatus::kSuccess;
+}
+
+
+MStatus PolyReorderNode::getIntArray(MDataBlock &dataBlock, MObject &attribute, MIntArray &values)
+{
+    MStatus status;
+
+    MDataHandle valuesHandle = dataBlock.inputValue(attribute, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    MObject valuesData = valuesHandle.data();
+
+    values.clear();
+
+    if (!valuesData.isNull())
+    {
+        MFnIntArrayData valuesDataFn(valuesData, &status);               
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        values = valuesDataFn.array(&status);                      
         CHECK_MSTATUS_AND_RETURN_IT(status);
     }
 
-    MFnMeshData outMeshData;
-    MObject outMesh = outMeshData.create(&status);
+    return MStatus::kSuccess;
+}
+
+
+/**
+    Reads numberOfThreads for the evaluation in progress. 0 uses every
+    hardware thread, as the command's -numberOfThreads flag does.
+*/
+MStatus PolyReorderNode::getNumberOfThreads(MDataBlock &dataBlock)
+{
+    MStatus status;
+
+    MDataHandle numberOfThreadsHandle = dataBlock.inputValue(numberOfThreadsAttr, &status);
     CHECK_MSTATUS_AND_RETURN_IT(status);
 
-    if (!inMesh.isNull())
+    numberOfThreads = numberOfThreadsHandle.asInt();
+
+    return MStatus::kSuccess;
+}
+
+
+/**
+    Splits a flat list of (vertex, edge, face) triplets into selections. A
+    trailing partial triplet is ignored.
+*/
+void PolyReorderNode::getSeeds(MIntArray &components, std::vector<polyReorder::ComponentSelection> &seeds)
+{
+    unsigned numberOfSeeds = components.length() / 3;
+
+    seeds.resize(numberOfSeeds);
+
+    for (unsigned i = 0; i < numberOfSeeds; i++)
     {
+        seeds[i].vertexIndex = components[i * 3];
+        seeds[i].edgeIndex   = components[i * 3 + 1];
+        seeds[i].faceIndex   = components[i * 3 + 2];
+    }
+}
+
+
+/**
+    Reorders a single input mesh into result.outMesh. A mesh that matches the
+    cache only has its points moved into a copy of the cached mesh; anything
+    else is rebuilt in full, and result.rebuilt is set so the caller can cache
+    it. On failure result.error says why and the output is the input mesh.
+    The cache is only read here.
+*/
+void PolyReorderNode::reorderElement(
+    MObject &inMesh, 
+    const std::vector<int> &order, 
+    uint64_t pointOrderKey, 
+    int numberOfThreads, 
+    MeshResult &result
+) {
+    ElementWork work;
+
+    readElement(inMesh, order, work, result);
+    matchElement(order, pointOrderKey, !cachedMesh.isNull(), numberOfThreads, work, result);
+    writeElement(inMesh, order, work, result);
+}
+
+
+/**
+    Checks inMesh against order and reads the arrays its key is hashed from
+    and its points, leaving work pending if it has to be reordered. Calls the
+    Maya API, so it runs on the evaluating thread.
+*/
+void PolyReorderNode::readElement(MObject &inMesh, const std::vector<int> &order, ElementWork &work, MeshResult &result)
+{
+    MStatus status;
+
+    result.outMesh = inMesh;
+
+    if (inMesh.isNull()) { return; }
+
+    MFnMesh inMeshFn(inMesh);
+
+    if (!polyReorder::isPermutation(order, inMeshFn.numVertices()))
+    {
+        result.error = "polyReorder node - pointOrder does not match the vertices of the input mesh.";
+        return;
+    }
+
+    if (polyReorder::isIdentityOrder(order)) { return; }
+
+    status = polyReorder::getMeshKeyArrays(inMesh, work.keyArrays);
+
+    if (status)
+    {
+        work.points = inMeshFn.getRawPoints(&status);
+    }
+
+    if (!status || work.points == nullptr)
+    {
+        result.error = "Mesh reorder failed.";
+        return;
+    }
+
+    work.pending = true;
+}
+
+
+/**
+    Hashes the key of a pending element and, if it matches the cache, moves
+    its points. Touches only plain arrays and the cache's keys, so elements
+    can be matched on any thread; hasCache is read by the caller, since the
+    cached mesh itself cannot be.
+*/
+void PolyReorderNode::matchElement(
+    const std::vector<int> &order, 
+    uint64_t pointOrderKey, 
+    bool hasCache, 
+    int numberOfThreads, 
+    ElementWork &work, 
+    MeshResult &result
+) {
+    if (!work.pending) { return; }
+
+    result.meshKey = polyReorder::getMeshKey(work.keyArrays, numberOfThreads);
+
+    work.isCached = hasCache && result.meshKey == cachedMeshKey && pointOrderKey == cachedPointOrder;
+
+    if (work.isCached)
+    {
+        polyReorder::reorderFloatPoints(work.points, order, work.reorderedPoints, numberOfThreads);
+    }
+}
+
+
+/**
+    Builds the output of a pending element: a copy of the cached mesh with
+    the moved points if it matched, or else a full rebuild. Calls the Maya
+    API, so it runs on the evaluating thread.
+*/
+void PolyReorderNode::writeElement(MObject &inMesh, const std::vector<int> &order, ElementWork &work, MeshResult &result)
+{
+    MStatus status;
+
+    if (!work.pending) { return; }
+
+    MFnMeshData outMeshData;
+    MObject outMesh;
+
+    if (work.isCached)
+    {
+        outMesh = outMeshData.create(&status);
+
+        if (status)
+        {
+            status = updatePoints(work.reorderedPoints, outMesh);
+        }
+
+        if (status)
+        {
+            result.outMesh = outMesh;
+            return;
+        }
+    }
+
+    outMesh = outMeshData.create(&status);
+
+    if (status)
+    {
+        MIntArray pointOrder(order.data(), (uint) order.size());
         status = polyReorder::reorderMesh(inMesh, inMesh, pointOrder, outMesh, true);
     }
 
     if (outMesh.isNull() || !status)
     {
         CHECK_MSTATUS(status);
-        MGlobal::displayError("Mesh reorder failed.");
-        outMesh = inMesh;
+        result.error = "Mesh reorder failed.";
+        return;
     }
 
-    if (!outMesh.isNull())
+    result.outMesh = outMesh;
+    result.rebuilt = true;
+}
+
+
+/**
+    Sets already reordered points, packed as xyzw, on a copy of the mesh
+    built by the last full compute, keeping its faces, UVs, normals and hard
+    edges. The cached mesh itself is never changed, since downstream nodes
+    and cached playback may still hold on to it.
+*/
+MStatus PolyReorderNode::updatePoints(const std::vector<float> &reorderedPoints, MObject &outMesh)
+{
+    MStatus status;
+
+    MFnMesh cachedMeshFn(cachedMesh, &status);
+    RETURN_IF_ERROR(status);
+
+    uint numVertices = (uint) (reorderedPoints.size() / 4);
+
+    if (cachedMeshFn.numVertices() != (int) numVertices)
     {
-        status = outMeshHandle.setMObject(outMesh);    
-        CHECK_MSTATUS_AND_RETURN_IT(status);
+        return MStatus::kFailure;
     }
-    
-    outMeshHandle.setClean();
 
-    return status;
-}
\ No newline at end of file
+    MFloatPointArray points((float (*)[4]) reorderedPoints.data(), numVertices);
+
+    return polyReorder::setPointsOnly(cachedMesh, points, outMesh, true);
+}
+
+
+void PolyReorderNode::setCache(MObject &mesh, const polyReorder::MeshKey &meshKey, uint64_t pointOrderKey)
+{
+    cachedMesh = mesh;
+    cachedMeshKey = meshKey;
+    cachedPointOrder = pointOrderKey;
+}
+
+
+/**
+    MGlobal is only safe on the main thread, so the message is queued for it
+    to display when it is next idle. A node that keeps failing the same way
+    reports once rather than on every evaluation.
+*/
+void PolyReorderNode::reportError(const MString &message)
+{
+    if (message == lastError) { return; }
+
+    lastError = message;
+
+    MGlobal::executeCommandOnIdle("warning \"" + message + "\"");
+}
+
+
+#if MAYA_API_VERSION >= 201600
+MPxNode::SchedulingType PolyReorderNode::schedulingType() const
+{
+    return MPxNode::kParallel;
+}
+#endif
@@ -6,12 +6,20 @@
 #ifndef POLY_REORDER_NODE_H
 #define POLY_REORDER_NODE_H
 
+#include "polyReorder.h"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
 #include <maya/MDataBlock.h>
+#include <maya/MIntArray.h>
 #include <maya/MObject.h>
 #include <maya/MPlug.h>
 #include <maya/MPxNode.h>
 #include <maya/MString.h>
 #include <maya/MStatus.h>
+#include <maya/MTypes.h>
 #include <maya/MTypeId.h>
 
 class PolyReorderNode : public MPxNode
@@ -22,13 +30,142 @@ public:
     
     virtual MStatus     compute(const MPlug &plug, MDataBlock &dataBlock);
 
+#if MAYA_API_VERSION >= 201600
+    virtual SchedulingType  schedulingType() const;
+#endif
+
+private:
+    /**
+        What reordering one input mesh produced, and the key it was built from.
+    */
+    struct MeshResult
+    {
+        MObject                 outMesh;
+        polyReorder::MeshKey    meshKey;
+        bool                    rebuilt     = false;
+        MString                 error;
+    };
+
+    /**
+        What one element's cache check and point gather need, read off its
+        mesh up front so that both can run off the evaluating thread.
+    */
+    struct ElementWork
+    {
+        bool                        pending     = false;
+        bool                        isCached    = false;
+        const float                 *points     = nullptr;
+        polyReorder::MeshKeyArrays  keyArrays;
+        std::vector<float>          reorderedPoints;
+    };
+
+            MStatus     computeMesh(MDataBlock &dataBlock);
+            MStatus     computeMeshes(MDataBlock &dataBlock);
+            MStatus     getPointOrder(
+                            MDataBlock &dataBlock, 
+                            MObject &destinationMesh, 
+                            const std::vector<int>* &order, 
+                            uint64_t &pointOrderKey, 
+                            MString &error
+                        );
+            MStatus     computePointOrder(
+                            MObject &sourceMesh, 
+                            MIntArray &sourceComponents, 
+                            MObject &destinationMesh, 
+                            MIntArray &destinationComponents, 
+                            MString &error
+                        );
+
+    static  MStatus     walkPointOrder(
+                            MObject &sourceMesh, 
+                            MIntArray &sourceComponents, 
+                            MObject &destinationMesh, 
+                            MIntArray &destinationComponents, 
+                            std::vector<int> &order, 
+                            MString &error,
+                            int numberOfThreads
+                        );
+
+    static  MStatus     getIntArray(MDataBlock &dataBlock, MObject &attribute, MIntArray &values);
+            MStatus     getNumberOfThreads(MDataBlock &dataBlock);
+    static  void        getSeeds(MIntArray &components, std::vector<polyReorder::ComponentSelection> &seeds);
+
+            void        reorderElement(
+                            MObject &inMesh, 
+                            const std::vector<int> &order, 
+                            uint64_t pointOrderKey, 
+                            int numberOfThreads, 
+                            MeshResult &result
+                        );
+
+            void        readElement(MObject &inMesh, const std::vector<int> &order, ElementWork &work, MeshResult &result);
+            void        matchElement(
+                            const std::vector<int> &order, 
+                            uint64_t pointOrderKey, 
+                            bool hasCache, 
+                            int numberOfThreads, 
+                            ElementWork &work, 
+                            MeshResult &result
+                        );
+            void        writeElement(MObject &inMesh, const std::vector<int> &order, ElementWork &work, MeshResult &result);
+
+            MStatus     updatePoints(const std::vector<float> &reorderedPoints, MObject &outMesh);
+            void        setCache(MObject &mesh, const polyReorder::MeshKey &meshKey, uint64_t pointOrderKey);
+            void        reportError(const MString &message);
+
 public:
     static MString      NODE_NAME;
     static MTypeId      NODE_ID;
     
     static MObject      inMeshAttr;
+    static MObject      inMeshesAttr;
     static MObject      pointOrderAttr;
+    static MObject      storedPointOrderAttr;
+    static MObject      sourceMeshAttr;
+    static MObject      sourceComponentsAttr;
+    static MObject      destinationComponentsAttr;
+    static MObject      numberOfThreadsAttr;
     static MObject      outMeshAttr;
+    static MObject      outMeshesAttr;
+
+private:
+    /**
+        The mesh built by the last full compute, and the key of the input mesh
+        and pointOrder it was built from. While both still match, only the
+        points are reordered into a copy of it. inMesh and every element of
+        inMeshes share it.
+    */
+    MObject                     cachedMesh;
+    polyReorder::MeshKey        cachedMeshKey;
+    uint64_t                    cachedPointOrder    = 0;
+
+    /**
+        The order last worked out from sourceMesh and the seeds, why it could
+        not be if it failed, the key of the meshes and seeds it came from, and
+        the key of the order itself.
+    */
+    bool                        hasComputedOrder        = false;
+    uint64_t                    computedOrderKey        = 0;
+    std::vector<int>            computedOrder;
+    uint64_t                    computedPointOrderKey   = 0;
+    MString                     computedOrderError;
+
+    /**
+        The entries of the pointOrder attribute, read on every evaluation.
+        The other orders are read where they are kept.
+    */
+    std::vector<int>            attributeOrder;
+
+    /**
+        The numberOfThreads of the evaluation in progress. It defaults to 1
+        because under parallel evaluation many nodes already run at once;
+        threads of its own would only compete with them.
+    */
+    int                         numberOfThreads     = 1;
+
+    std::mutex                  cacheMutex;
+
+    MString                     lastError;
 };
 
 #endif
\ No newline at end of file
@@ -40,9 +40,6 @@ PolyReorderTool::~PolyReorderTool()
 
 void PolyReorderTool::toolOnSetup(MEvent &event) 
 {
-    sourceMeshData = MeshData();
-    destinationMeshData = MeshData();
-
     this->updateHelpString();
 }
 
@@ -267,8 +264,7 @@ MStatus PolyReorderTool::getSelectedMesh()
         case polyReorder::ToolState::SELECT_SOURCE_MESH:           
             sourceMesh.set(mesh);
             
-            sourceMeshData.unpackMesh(sourceMesh);
-            sourceMeshTopology.setMesh(sourceMesh);
+            polyReorder::getMeshTopology(sourceMesh, sourceMeshTopology);
             getDisplayColors(sourceMesh, originalSourceDisplayColors);
 
             parseArgs::toTransform(sourceMesh);
@@ -281,7 +277,7 @@ MStatus PolyReorderTool::getSelectedMesh()
                 return MStatus::kFailure;
             } 
 
-            if (!MeshTopology::hasSameTopology(mesh, sourceMesh))
+            if (!polyReorder::hasSameTopology(mesh, sourceMesh))
             {
                 MGlobal::displayError("Source and destination meshes must have the same topology.");
                 return MStatus::kFailure;
@@ -289,8 +285,7 @@ MStatus PolyReorderTool::getSelectedMesh()
 
             destinationMesh.set(mesh);
 
-            destinationMeshData.unpackMesh(destinationMesh);
-            destinationMeshTopology.setMesh(destinationMesh);
+            polyReorder::getMeshTopology(destinationMesh, destinationMeshTopology);
             getDisplayColors(destinationMesh, originalDestinationDisplayColors);
 
             parseArgs::toTransform(destinationMesh);
@@ -310,13 +305,13 @@ MStatus PolyReorderTool::clearSelectedMesh()
         case polyReorder::ToolState::SELECT_DESTINATION_MESH:
             clearDisplayColors(sourceMesh, originalSourceDisplayColors);
             sourceMesh.set(MDagPath());
-            sourceMeshData.clear();
+            sourceMeshTopology.data().clear();
         break;
 
         case polyReorder::ToolState::SELECT_COMPONENTS:
             clearDisplayColors(destinationMesh, originalDestinationDisplayColors);
             destinationMesh.set(MDagPath());
-            destinationMeshData.clear();
+            destinationMeshTopology.data().clear();
         break;
     }
 
@@ -409,10 +404,10 @@ MStatus PolyReorderTool::getSelectedComponents()
     polyReorder::ComponentSelection src;
     polyReorder::ComponentSelection dst;
 
-    status = getSelectedComponentsOnMesh(activeSelection, sourceMesh, sourceMeshData, src);
+    status = getSelectedComponentsOnMesh(activeSelection, sourceMesh, sourceMeshTopology.data(), src);
     RETURN_IF_ERROR(status);
 
-    status = getSelectedComponentsOnMesh(activeSelection, destinationMesh, destinationMeshData, dst);
+    status = getSelectedComponentsOnMesh(activeSelection, destinationMesh, destinationMeshTopology.data(), dst);
     RETURN_IF_ERROR(status);
 
     sourceComponents.push_back(src);
@@ -450,8 +445,8 @@ MStatus PolyReorderTool::getSelectedComponentsOnMesh(
         s.faceIndex = parseArgs::getComponentIndex(face);
         s.vertexIndex = parseArgs::getComponentIndex(vertex);
 
-        bool edgeOnFace = contains(meshData.faceData[s.faceIndex].connectedEdges, s.edgeIndex);
-        bool vertexOnEdge = contains(meshData.edgeData[s.edgeIndex].connectedVertices, s.vertexIndex);
+        bool edgeOnFace = contains(meshData.faceEdges(s.faceIndex), s.edgeIndex);
+        bool vertexOnEdge = contains(meshData.edgeVertices(s.edgeIndex), s.vertexIndex);
 
         if (edgeOnFace && vertexOnEdge)
         {
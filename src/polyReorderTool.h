@@ -75,9 +75,6 @@ private:
     MDagPath                        sourceMesh;
     MDagPath                        destinationMesh;
 
-    MeshData                        sourceMeshData;
-    MeshData                        destinationMeshData;
-
     MeshTopology                    sourceMeshTopology;
     MeshTopology                    destinationMeshTopology;
 